@@ -0,0 +1,452 @@
+#include "BatchValidator.hh"
+
+#include "CompressedGDMLSource.hh"
+#include "GeometryStats.hh"
+#include "JSON.hh"
+#include "PosixIO.hh"
+#include "ProfilingNavigator.hh"
+
+#include "G4GDMLParser.hh"
+#include "G4VExceptionHandler.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4GeometryManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+
+#include <boost/thread/thread.hpp>
+
+#include <unistd.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    using latte::json::Quote;
+    using latte::io::WriteAll;
+    using latte::profile::Milliseconds;
+
+    //----- Issues kept per file, beyond which they are only counted
+    const size_t kMaxIssues = 1000;
+
+    //----- Worker output kept for files that crash
+    const size_t kLogTail = 4096;
+
+    bool EndsWith(const std::string& s, const std::string& suffix)
+    {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    //----- True if output names one of the inputs, or looks like one, so
+    // that opening it for the report would destroy a geometry
+    bool IsInput(const std::string& output, const std::vector<std::string>& files)
+    {
+        if(EndsWith(output, ".gdml") || EndsWith(output, ".gz") || EndsWith(output, ".zst")) return true;
+
+        struct stat out;
+        bool exists = ::stat(output.c_str(), &out) == 0;
+        for(std::vector<std::string>::const_iterator file = files.begin(); file != files.end(); ++file) {
+            if(*file == output) return true;
+            struct stat in;
+            if(exists && ::stat(file->c_str(), &in) == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino) return true;
+        }
+        return false;
+    }
+
+    //----- Worker exit codes
+    const int kExitOk = 0;
+    const int kExitOverlaps = 1;
+    const int kExitError = 2;
+
+    //----- Keep the last kLogTail bytes of log, starting on a whole UTF-8
+    // character so the report stays valid JSON
+    void TrimLog(std::string& log)
+    {
+        if(log.size() <= kLogTail) return;
+        std::string::size_type cut = log.size() - kLogTail;
+        while(cut < log.size() && (static_cast<unsigned char>(log[cut]) & 0xC0) == 0x80) ++cut;
+        log.erase(0, cut);
+    }
+
+    const char* StatusName(int exitCode)
+    {
+        switch(exitCode) {
+            case kExitOk:       return "ok";
+            case kExitOverlaps: return "overlaps";
+            default:            return "error";
+        }
+    }
+
+    struct Issue
+    {
+        std::string origin;
+        std::string code;
+        std::string volume;
+        std::string message;
+    };
+
+    //----- What a worker found, written back to the parent as the body of
+    // a JSON object
+    struct FileReport
+    {
+        FileReport() : exitCode(kExitOk), error(), loadMs(0.0), overlapMs(0.0), stats(), overlaps(), nOverlaps(0),
+        warnings(), nWarnings(0) {;}
+
+        void Add(std::vector<Issue>& issues, size_t& count, const Issue& issue)
+        {
+            if(count++ < kMaxIssues) issues.push_back(issue);
+        }
+
+        std::string Body() const
+        {
+            std::ostringstream os;
+            os<<"\"status\": "<<Quote(StatusName(exitCode));
+            if(!error.empty()) os<<", \"error\": "<<Quote(error);
+            os<<", \"load_ms\": "<<loadMs<<", \"overlap_ms\": "<<overlapMs;
+            if(!stats.empty()) os<<", \"stats\": "<<stats;
+            os<<", \"overlap_count\": "<<nOverlaps<<", \"overlaps\": ";
+            WriteIssues(overlaps, os);
+            os<<", \"warning_count\": "<<nWarnings<<", \"warnings\": ";
+            WriteIssues(warnings, os);
+            return os.str();
+        }
+
+        static void WriteIssues(const std::vector<Issue>& issues, std::ostream& os)
+        {
+            os<<"[";
+            for(size_t i = 0; i < issues.size(); ++i) {
+                const Issue& issue = issues[i];
+                os<<(i ? ", " : "")<<"{\"origin\": "<<Quote(issue.origin)<<", \"code\": "<<Quote(issue.code);
+                if(!issue.volume.empty()) os<<", \"volume\": "<<Quote(issue.volume);
+                os<<", \"message\": "<<Quote(issue.message)<<"}";
+            }
+            os<<"]";
+        }
+
+        int                exitCode;
+        std::string        error;
+        double             loadMs;
+        double             overlapMs;
+        std::string        stats;
+        std::vector<Issue> overlaps;
+        size_t             nOverlaps;
+        std::vector<Issue> warnings;
+        size_t             nWarnings;
+    };
+
+    //----- Report the file and leave, without running static destructors
+    void ExitWorker(const FileReport& report, int resultFd)
+    {
+        WriteAll(resultFd, report.Body());
+        ::close(resultFd);
+        G4cout.flush();
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(report.exitCode);
+    }
+
+    //----- Records G4Exceptions in the report. A fatal one ends the worker
+    // with what has been found so far, rather than aborting it.
+    class ExceptionRecorder : public G4VExceptionHandler
+    {
+        public:
+            ExceptionRecorder(FileReport* report, int resultFd) : G4VExceptionHandler(), pReport_(report),
+            resultFd_(resultFd), volume_() {;}
+
+            //----- Volume whose overlaps are being checked
+            void SetVolume(const std::string& volume) {volume_ = volume;}
+
+            virtual G4bool Notify(const char* originOfException, const char* exceptionCode,
+                    G4ExceptionSeverity severity, const char* description)
+            {
+                Issue issue;
+                issue.origin = originOfException;
+                issue.code = exceptionCode;
+                issue.message = description;
+
+                if(severity == FatalException || severity == FatalErrorInArgument) {
+                    pReport_->exitCode = kExitError;
+                    pReport_->error = issue.origin+" "+issue.code+": "+issue.message;
+                    ExitWorker(*pReport_, resultFd_);
+                }
+
+                //----- G4PVPlacement::CheckOverlaps
+                if(issue.code == "GeomVol1002") {
+                    issue.volume = volume_;
+                    pReport_->Add(pReport_->overlaps, pReport_->nOverlaps, issue);
+                }
+                else {
+                    pReport_->Add(pReport_->warnings, pReport_->nWarnings, issue);
+                }
+                return false;
+            }
+
+        private:
+            FileReport* pReport_;
+            int         resultFd_;
+            std::string volume_;
+    };
+}
+
+namespace latte {
+    namespace validate {
+
+        BatchValidator::BatchValidator() : nJobs_(0), timeout_(0), resolution_(1000), nTop_(10)
+        {;}
+
+
+        BatchValidator::~BatchValidator()
+        {;}
+
+
+        int BatchValidator::Run(const std::vector<std::string>& files, const std::string& output)
+        {
+            //----- Open the report first, so a bad path fails before any
+            // file is validated rather than after all of them
+            std::ofstream reportFile;
+            if(output != "-") {
+                if(IsInput(output, files)) {
+                    std::cerr<<"gdmlview: report \""<<output<<"\" would overwrite a gdml file"<<std::endl;
+                    return files.empty() ? 1 : static_cast<int>(files.size());
+                }
+                reportFile.open(output.c_str());
+                if(!reportFile) {
+                    std::cerr<<"gdmlview: cannot write report \""<<output<<"\""<<std::endl;
+                    return files.empty() ? 1 : static_cast<int>(files.size());
+                }
+            }
+            std::ostream& os = output == "-" ? std::cout : reportFile;
+
+            uint64_t start = latte::profile::WallClockNs();
+            size_t nJobs = static_cast<size_t>(this->NumberOfJobs());
+            std::vector<std::string> results(files.size());
+            std::vector<Worker> running;
+            size_t next(0), nDone(0);
+            int nFailed(0);
+
+            while(next < files.size() || !running.empty()) {
+                //----- Keep every job slot busy
+                while(running.size() < nJobs && next < files.size()) {
+                    Worker worker;
+                    if(this->Spawn(next, files[next], worker)) {
+                        running.push_back(worker);
+                    }
+                    else {
+                        results[next] = "{\"file\": "+Quote(files[next])+", \"status\": \"error\", \"error\": \"cannot start worker\"}";
+                        ++nFailed;
+                        ++nDone;
+                    }
+                    ++next;
+                }
+
+                //----- Drain worker output until a worker closes both pipes
+                std::vector<pollfd> fds;
+                std::vector<Worker*> owners;
+                for(std::vector<Worker>::iterator w = running.begin(); w != running.end(); ++w) {
+                    int ends[2] = {w->resultFd, w->logFd};
+                    for(int i = 0; i < 2; ++i) {
+                        if(ends[i] < 0) continue;
+                        pollfd p = {ends[i], POLLIN, 0};
+                        fds.push_back(p);
+                        owners.push_back(&*w);
+                    }
+                }
+                if(!fds.empty() && ::poll(&fds[0], fds.size(), -1) < 0 && errno != EINTR) {
+                    std::perror("gdmlview: poll");
+                    break;
+                }
+
+                char buffer[1 << 16];
+                for(size_t i = 0; i < fds.size(); ++i) {
+                    if(!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+                    ssize_t n = ::read(fds[i].fd, buffer, sizeof(buffer));
+                    if(n < 0 && errno == EINTR) continue;
+
+                    Worker* w = owners[i];
+                    bool isResult(fds[i].fd == w->resultFd);
+                    if(n <= 0) {
+                        ::close(fds[i].fd);
+                        (isResult ? w->resultFd : w->logFd) = -1;
+                    }
+                    else if(isResult) {
+                        w->result.append(buffer, n);
+                    }
+                    else {
+                        w->log.append(buffer, n);
+                        TrimLog(w->log);
+                    }
+                }
+
+                //----- Collect workers that have finished
+                for(std::vector<Worker>::iterator w = running.begin(); w != running.end(); ) {
+                    if(w->resultFd >= 0 || w->logFd >= 0) {
+                        ++w;
+                        continue;
+                    }
+
+                    int status(0);
+                    while(::waitpid(w->pid, &status, 0) < 0 && errno == EINTR) {;}
+                    bool ok = WIFEXITED(status) && WEXITSTATUS(status) == kExitOk;
+                    if(!ok) ++nFailed;
+
+                    results[w->index] = this->Finish(*w, status, files[w->index]);
+                    std::cerr<<"gdmlview: ["<<++nDone<<"/"<<files.size()<<"] "<<files[w->index]<<": "
+                        <<(ok ? "ok" : "FAILED")<<std::endl;
+                    w = running.erase(w);
+                }
+            }
+
+            //----- One document for all files
+            uint64_t elapsed = latte::profile::WallClockNs() - start;
+            this->WriteReport(files, results, nFailed, elapsed, os);
+            if(!os) {
+                std::cerr<<"gdmlview: error writing report \""<<output<<"\""<<std::endl;
+                return files.empty() ? 1 : static_cast<int>(files.size());
+            }
+            return nFailed;
+        }
+
+
+        bool BatchValidator::Spawn(size_t index, const std::string& file, Worker& worker)
+        {
+            int resultPipe[2], logPipe[2];
+            if(::pipe(resultPipe) < 0) return false;
+            if(::pipe(logPipe) < 0) {
+                ::close(resultPipe[0]);
+                ::close(resultPipe[1]);
+                return false;
+            }
+
+            //----- Nothing buffered may be written twice
+            std::cout.flush();
+            std::cerr.flush();
+
+            pid_t pid = ::fork();
+            if(pid == 0) {
+                ::close(resultPipe[0]);
+                ::close(logPipe[0]);
+                ::dup2(logPipe[1], STDOUT_FILENO);
+                ::dup2(logPipe[1], STDERR_FILENO);
+                ::close(logPipe[1]);
+                this->ValidateInChild(file, resultPipe[1]);
+                _exit(kExitError);
+            }
+
+            ::close(resultPipe[1]);
+            ::close(logPipe[1]);
+            if(pid < 0) {
+                ::close(resultPipe[0]);
+                ::close(logPipe[0]);
+                return false;
+            }
+
+            worker.pid = pid;
+            worker.index = index;
+            worker.resultFd = resultPipe[0];
+            worker.logFd = logPipe[0];
+            worker.start = latte::profile::WallClockNs();
+            return true;
+        }
+
+
+        void BatchValidator::ValidateInChild(const std::string& file, int resultFd)
+        {
+            //----- Never returns. SIGALRM kills the worker on timeout.
+            if(timeout_) ::alarm(timeout_);
+
+            FileReport report;
+            ExceptionRecorder recorder(&report, resultFd);
+
+            uint64_t t0 = latte::profile::WallClockNs();
+            G4VPhysicalVolume* pWorld(0);
+            {
+                latte::geometry::CompressedGDMLSource source;
+                G4GDMLParser parser;
+                parser.Read(source.Open(file));
+                pWorld = parser.GetWorldVolume();
+            }
+            report.loadMs = Milliseconds(latte::profile::WallClockNs() - t0);
+
+            if(!pWorld) {
+                report.exitCode = kExitError;
+                report.error = "no world volume";
+                ExitWorker(report, resultFd);
+            }
+
+            //----- Closed first, so that voxels are counted
+            G4GeometryManager::GetInstance()->CloseGeometry(true, false, pWorld);
+            latte::geometry::GeometryStats stats;
+            stats.Collect(pWorld);
+            std::ostringstream statsJSON;
+            stats.WriteJSON(statsJSON, nTop_);
+            report.stats = statsJSON.str();
+
+            //----- Placements check themselves against mother and sisters
+            t0 = latte::profile::WallClockNs();
+            G4PhysicalVolumeStore* pvStore = G4PhysicalVolumeStore::GetInstance();
+            size_t nOverlapping(0);
+            for(G4PhysicalVolumeStore::const_iterator pv = pvStore->begin(); pv != pvStore->end(); ++pv) {
+                recorder.SetVolume((*pv)->GetName());
+                if((*pv)->CheckOverlaps(resolution_, 0.0, false)) ++nOverlapping;
+            }
+            report.overlapMs = Milliseconds(latte::profile::WallClockNs() - t0);
+
+            report.exitCode = nOverlapping ? kExitOverlaps : kExitOk;
+            ExitWorker(report, resultFd);
+        }
+
+
+        std::string BatchValidator::Finish(Worker& worker, int status, const std::string& file)
+        {
+            std::ostringstream os;
+            os<<"{\"file\": "<<Quote(file)<<", \"wall_ms\": "<<Milliseconds(latte::profile::WallClockNs() - worker.start);
+
+            if(WIFEXITED(status) && WEXITSTATUS(status) <= kExitError && !worker.result.empty()) {
+                os<<", \"exit\": "<<WEXITSTATUS(status)<<", "<<worker.result;
+                if(WEXITSTATUS(status) == kExitError) os<<", \"log\": "<<Quote(worker.log);
+            }
+            else if(WIFSIGNALED(status)) {
+                int sig = WTERMSIG(status);
+                os<<", \"status\": "<<Quote(sig == SIGALRM && timeout_ ? "timeout" : "crashed")
+                  <<", \"signal\": "<<sig<<", \"log\": "<<Quote(worker.log);
+            }
+            else {
+                os<<", \"status\": \"error\", \"exit\": "<<(WIFEXITED(status) ? WEXITSTATUS(status) : -1)
+                  <<", \"log\": "<<Quote(worker.log);
+            }
+            os<<"}";
+            return os.str();
+        }
+
+
+        void BatchValidator::WriteReport(const std::vector<std::string>& files, const std::vector<std::string>& results,
+                int nFailed, uint64_t elapsed, std::ostream& os) const
+        {
+            os<<"{\n"
+              <<"  \"files\": "<<files.size()<<",\n"
+              <<"  \"passed\": "<<static_cast<int>(files.size()) - nFailed<<",\n"
+              <<"  \"failed\": "<<nFailed<<",\n"
+              <<"  \"jobs\": "<<this->NumberOfJobs()<<",\n"
+              <<"  \"overlap_resolution\": "<<resolution_<<",\n"
+              <<"  \"wall_ms\": "<<Milliseconds(elapsed)<<",\n"
+              <<"  \"results\": [";
+            for(size_t i = 0; i < results.size(); ++i) {
+                os<<(i ? ",\n    " : "\n    ")<<results[i];
+            }
+            os<<(results.empty() ? "]\n" : "\n  ]\n")<<"}"<<std::endl;
+        }
+
+
+        int BatchValidator::NumberOfJobs() const
+        {
+            if(nJobs_ > 0) return nJobs_;
+            int nCores = static_cast<int>(boost::thread::hardware_concurrency());
+            return nCores > 0 ? nCores : 1;
+        }
+
+    } // namespace validate
+} // namespace latte
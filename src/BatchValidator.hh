@@ -0,0 +1,86 @@
+#ifndef BATCHVALIDATOR_HH
+#define BATCHVALIDATOR_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Validates many GDML files in one go, e.g. every variant of a
+//              geometry in CI. Each file is loaded, overlap checked and
+//              summarized in its own forked worker process, so Geant4's
+//              global stores start empty for every file and a crash only
+//              loses that file. At most one worker per core (or as set)
+//              runs at once.
+//
+//              Workers report back over a pipe, and the results for all
+//              files are written as a single JSON document, in input order.
+//              Fork before any Geant4 state exists in the process.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace latte {
+    namespace validate {
+
+        class BatchValidator
+        {
+            public:
+                BatchValidator();
+                ~BatchValidator();
+
+                //----- 0 runs one worker per core
+                void SetJobs(int nJobs) {nJobs_ = nJobs > 0 ? nJobs : 0;}
+
+                //----- Seconds before a worker is killed, 0 for no limit
+                void SetTimeout(int seconds) {timeout_ = seconds > 0 ? seconds : 0;}
+
+                //----- Surface points per volume in the overlap check
+                void SetOverlapResolution(int points) {resolution_ = points > 0 ? points : 1000;}
+
+                //----- Heaviest logical volumes listed in each file's stats
+                void SetTopVolumes(int nTop) {nTop_ = nTop > 0 ? nTop : 0;}
+
+                //----- Validate files, writing the report to output, "-"
+                // for stdout. Returns the number of files that failed. An
+                // output that is, or looks like, one of the files is refused.
+                int Run(const std::vector<std::string>& files, const std::string& output);
+
+            private:
+                struct Worker
+                {
+                    Worker() : pid(-1), index(0), resultFd(-1), logFd(-1), result(), log(), start(0) {;}
+
+                    pid_t       pid;
+                    size_t      index;
+                    int         resultFd;
+                    int         logFd;
+                    std::string result;
+                    std::string log;
+                    uint64_t    start;
+                };
+
+            private:
+                bool Spawn(size_t index, const std::string& file, Worker& worker);
+                void ValidateInChild(const std::string& file, int resultFd);
+                std::string Finish(Worker& worker, int status, const std::string& file);
+                void WriteReport(const std::vector<std::string>& files, const std::vector<std::string>& results,
+                        int nFailed, uint64_t elapsed, std::ostream& os) const;
+
+                int NumberOfJobs() const;
+
+            private:
+                int nJobs_;
+                int timeout_;
+                int resolution_;
+                int nTop_;
+        };
+
+    } // namespace validate
+} // namespace latte
+#endif // BATCHVALIDATOR_HH
@@ -0,0 +1,445 @@
+#include "BulkLocator.hh"
+
+#include "PointLocator.hh"
+#include "ProfilingNavigator.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4Material.hh"
+
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace {
+    //----- Reads "x y z" text rows, or raw float64/float32 triples, in
+    // batches
+    class PointReader
+    {
+        public:
+            enum Format {Text, Float64, Float32};
+
+        public:
+            PointReader(const std::string& fileName) : pFile_(0), format_(Text), pLine_(0), lineSize_(0),
+            nLines_(0), seenData_(false), failed_(false)
+            {
+                if(fileName == "-") {
+                    pFile_ = stdin;
+                    return;
+                }
+
+                if(HasSuffix(fileName, ".f64") || HasSuffix(fileName, ".bin")) format_ = Float64;
+                if(HasSuffix(fileName, ".f32")) format_ = Float32;
+                pFile_ = std::fopen(fileName.c_str(), format_ == Text ? "r" : "rb");
+            }
+
+            ~PointReader()
+            {
+                std::free(pLine_);
+                if(pFile_ && pFile_ != stdin) std::fclose(pFile_);
+            }
+
+            bool IsOpen() const {return pFile_ != 0;}
+            bool Failed() const {return failed_;}
+            size_t GetLineNumber() const {return nLines_;}
+
+            //----- Replace batch with up to n points, 0 at the end or on
+            // error
+            size_t Read(std::vector<G4ThreeVector>& batch, size_t n)
+            {
+                batch.clear();
+                if(failed_) return 0;
+
+                switch(format_) {
+                    case Float64: return this->ReadBinary<double>(batch, n);
+                    case Float32: return this->ReadBinary<float>(batch, n);
+                    default: return this->ReadText(batch, n);
+                }
+            }
+
+        private:
+            template<typename T>
+            size_t ReadBinary(std::vector<G4ThreeVector>& batch, size_t n)
+            {
+                buffer_.resize(3*n*sizeof(T));
+                size_t nRead = std::fread(&buffer_[0], sizeof(T), 3*n, pFile_);
+                if(nRead % 3) failed_ = true;
+
+                const T* v = reinterpret_cast<const T*>(&buffer_[0]);
+                for(size_t i = 0; i + 2 < nRead; i += 3) {
+                    if(!IsFinite(v[i]) || !IsFinite(v[i+1]) || !IsFinite(v[i+2])) {
+                        failed_ = true;
+                        break;
+                    }
+                    batch.push_back(G4ThreeVector(v[i], v[i+1], v[i+2]));
+                }
+                return batch.size();
+            }
+
+            size_t ReadText(std::vector<G4ThreeVector>& batch, size_t n)
+            {
+                while(batch.size() < n && ::getline(&pLine_, &lineSize_, pFile_) > 0) {
+                    ++nLines_;
+                    const char* p = pLine_;
+                    while(*p == ' ' || *p == '\t') ++p;
+                    if(*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+                    G4double xyz[3];
+                    bool ok = true;
+                    for(int i = 0; i < 3 && ok; ++i) {
+                        while(*p == ' ' || *p == '\t' || *p == ',' || *p == ';') ++p;
+                        char* end = 0;
+                        xyz[i] = std::strtod(p, &end);
+                        ok = end != p;
+                        p = end;
+                    }
+
+                    if(ok && !(IsFinite(xyz[0]) && IsFinite(xyz[1]) && IsFinite(xyz[2]))) {
+                        failed_ = true;
+                        return 0;
+                    }
+
+                    if(!ok) {
+                        //----- Allow a single column header
+                        if(!seenData_) {
+                            seenData_ = true;
+                            continue;
+                        }
+                        failed_ = true;
+                        return 0;
+                    }
+                    seenData_ = true;
+                    batch.push_back(G4ThreeVector(xyz[0], xyz[1], xyz[2]));
+                }
+                return batch.size();
+            }
+
+            //----- NaN and inf have no place in the world, nor on the
+            // Morton curve
+            static bool IsFinite(G4double v)
+            {
+                return v == v && v - v == 0.0;
+            }
+
+            static bool HasSuffix(const std::string& s, const std::string& suffix)
+            {
+                return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+            }
+
+        private:
+            FILE*             pFile_;
+            Format            format_;
+            std::vector<char> buffer_;
+            char*             pLine_;
+            size_t            lineSize_;
+            size_t            nLines_;
+            bool              seenData_;
+            bool              failed_;
+    };
+
+
+    //----- Interleave the low 21 bits of v with two zero bits
+    inline uint64_t Spread21(uint64_t v)
+    {
+        v &= 0x1fffffULL;
+        v = (v | (v << 32)) & 0x1f00000000ffffULL;
+        v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+        v = (v | (v << 8))  & 0x100f00f00f00f00fULL;
+        v = (v | (v << 4))  & 0x10c30c30c30c30c3ULL;
+        v = (v | (v << 2))  & 0x1249249249249249ULL;
+        return v;
+    }
+
+    //----- Cell of a scaled coordinate, clamped to 21 bits. Rounding can
+    // put the far corner just outside.
+    inline uint64_t Cell(G4double v)
+    {
+        const G4double kMaxCell = 2097151.0;
+        if(!(v > 0.0)) return 0;
+        return v < kMaxCell ? static_cast<uint64_t>(v) : static_cast<uint64_t>(kMaxCell);
+    }
+
+    typedef std::pair<uint64_t, uint32_t> SortKey;
+
+    //----- Order the batch along a Morton curve over its bounding box
+    void SortBatch(const std::vector<G4ThreeVector>& raw, uint64_t first, std::vector<SortKey>& keys,
+            std::vector<G4ThreeVector>& sorted, std::vector<uint64_t>& index)
+    {
+        G4ThreeVector lo(raw[0]), hi(raw[0]);
+        for(std::vector<G4ThreeVector>::const_iterator p = raw.begin(); p != raw.end(); ++p) {
+            lo.set(std::min(lo.x(), p->x()), std::min(lo.y(), p->y()), std::min(lo.z(), p->z()));
+            hi.set(std::max(hi.x(), p->x()), std::max(hi.y(), p->y()), std::max(hi.z(), p->z()));
+        }
+
+        const G4double cells = 2097151.0;
+        G4ThreeVector extent(hi - lo);
+        G4double sx = extent.x() > 0.0 ? cells/extent.x() : 0.0;
+        G4double sy = extent.y() > 0.0 ? cells/extent.y() : 0.0;
+        G4double sz = extent.z() > 0.0 ? cells/extent.z() : 0.0;
+
+        keys.resize(raw.size());
+        for(size_t i = 0; i < raw.size(); ++i) {
+            const G4ThreeVector& p = raw[i];
+            uint64_t key = Spread21(Cell((p.x() - lo.x())*sx))
+                | (Spread21(Cell((p.y() - lo.y())*sy)) << 1)
+                | (Spread21(Cell((p.z() - lo.z())*sz)) << 2);
+            keys[i] = SortKey(key, static_cast<uint32_t>(i));
+        }
+        std::sort(keys.begin(), keys.end());
+
+        sorted.resize(raw.size());
+        index.resize(raw.size());
+        for(size_t i = 0; i < keys.size(); ++i) {
+            sorted[i] = raw[keys[i].second];
+            index[i] = first + keys[i].second;
+        }
+    }
+
+
+    //----- Formats one CSV row per located point
+    struct RowFormatter
+    {
+        RowFormatter(const uint64_t* idx, std::string* rows) : index(idx), out(rows), nOutside(0) {;}
+
+        void operator()(size_t i, const latte::geometry::PointLocator::Location& loc)
+        {
+            char num[32];
+            std::sprintf(num, "%llu,", static_cast<unsigned long long>(index[i]));
+            out->append(num);
+
+            if(!loc.IsValid()) {
+                out->append("-,-1,-,-\n");
+                ++nOutside;
+                return;
+            }
+
+            out->append(loc.volumes.back()->GetName());
+            std::sprintf(num, ",%d,", loc.copyNumbers.back());
+            out->append(num);
+            out->append(loc.material ? loc.material->GetName().c_str() : "-");
+            out->append(",");
+            for(size_t level = 0; level < loc.volumes.size(); ++level) {
+                std::sprintf(num, ":%d", loc.copyNumbers[level]);
+                out->append("/");
+                out->append(loc.volumes[level]->GetName());
+                out->append(num);
+            }
+            out->append("\n");
+        }
+
+        const uint64_t* index;
+        std::string*    out;
+        uint64_t        nOutside;
+    };
+
+
+    //----- One contiguous run of a sorted batch
+    struct LocateTask
+    {
+        LocateTask() : pLocator(0), begin(0), end(0), index(0), nOutside(0) {;}
+
+        void Run()
+        {
+            rows.clear();
+            rows.reserve(96*(end - begin));
+            RowFormatter formatter(index, &rows);
+            pLocator->LocateRange(begin, end, formatter);
+            nOutside = formatter.nOutside;
+        }
+
+        latte::geometry::PointLocator* pLocator;
+        const G4ThreeVector* begin;
+        const G4ThreeVector* end;
+        const uint64_t*      index;
+        std::string          rows;
+        uint64_t             nOutside;
+    };
+
+
+    //----- One thread per task for a whole Run, so each keeps its
+    // navigator, and the history in it, from batch to batch. Start() runs
+    // every task once, Wait() returns when all have finished.
+    class TaskPool
+    {
+        public:
+            TaskPool(std::vector<LocateTask>& tasks) : tasks_(tasks), mutex_(), startCond_(), doneCond_(),
+            batch_(0), nPending_(0), stopping_(false), threads_()
+            {
+                for(size_t t = 0; t < tasks_.size(); ++t) {
+                    threads_.create_thread(boost::bind(&TaskPool::Loop, this, t));
+                }
+            }
+
+            ~TaskPool()
+            {
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    stopping_ = true;
+                }
+                startCond_.notify_all();
+                threads_.join_all();
+            }
+
+            void Start()
+            {
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    ++batch_;
+                    nPending_ = tasks_.size();
+                }
+                startCond_.notify_all();
+            }
+
+            void Wait()
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                while(nPending_) doneCond_.wait(lock);
+            }
+
+        private:
+            void Loop(size_t t)
+            {
+                unsigned long done(0);
+                while(true) {
+                    {
+                        boost::mutex::scoped_lock lock(mutex_);
+                        while(batch_ == done && !stopping_) startCond_.wait(lock);
+                        if(batch_ == done) return;
+                        done = batch_;
+                    }
+
+                    if(tasks_[t].begin != tasks_[t].end) tasks_[t].Run();
+
+                    boost::mutex::scoped_lock lock(mutex_);
+                    if(--nPending_ == 0) doneCond_.notify_all();
+                }
+            }
+
+        private:
+            std::vector<LocateTask>& tasks_;
+            boost::mutex              mutex_;
+            boost::condition_variable startCond_;
+            boost::condition_variable doneCond_;
+            unsigned long             batch_;
+            size_t                    nPending_;
+            bool                      stopping_;
+            boost::thread_group       threads_;
+    };
+}
+
+namespace latte {
+    namespace geometry {
+
+        BulkLocator::BulkLocator(PointLocator* locator) : pLocator_(locator), nThreads_(0), batchSize_(1 << 20)
+        {;}
+
+
+        BulkLocator::~BulkLocator()
+        {;}
+
+
+        G4int BulkLocator::NumberOfThreads(std::ostream& log)
+        {
+            if(!pLocator_->IsParallelSafe()) {
+                log<<"gdmlview: geometry cannot be navigated by several threads at once, locating on one thread"<<G4endl;
+                return 1;
+            }
+            if(nThreads_ > 0) return nThreads_;
+
+            G4int nCores = static_cast<G4int>(boost::thread::hardware_concurrency());
+            return nCores > 0 ? nCores : 1;
+        }
+
+
+        bool BulkLocator::Run(const std::string& inFile, const std::string& outFile)
+        {
+            PointReader reader(inFile);
+            if(!reader.IsOpen()) {
+                G4cerr<<"gdmlview: cannot open point file \""<<inFile<<"\""<<G4endl;
+                return false;
+            }
+
+            FILE* pOut = outFile == "-" ? stdout : std::fopen(outFile.c_str(), "w");
+            if(!pOut) {
+                G4cerr<<"gdmlview: cannot open location output file \""<<outFile<<"\""<<G4endl;
+                return false;
+            }
+            bool isWritten = std::fputs("index,volume,copyNo,material,path\n", pOut) >= 0;
+
+            //----- Keep notes out of CSV written to stdout
+            std::ostream& log = pOut == stdout ? G4cerr : G4cout;
+            G4int nThreads = this->NumberOfThreads(log);
+            std::vector<LocateTask> tasks(nThreads);
+            for(G4int t = 0; t < nThreads; ++t) tasks[t].pLocator = pLocator_;
+
+            std::vector<G4ThreeVector> raw;
+            std::vector<G4ThreeVector> sorted;
+            std::vector<SortKey>       keys;
+            std::vector<uint64_t>      index;
+            uint64_t nPoints(0), nOutside(0);
+            uint64_t start = latte::profile::WallClockNs();
+
+            TaskPool workers(tasks);
+            size_t n = reader.Read(raw, batchSize_);
+            while(n) {
+                SortBatch(raw, nPoints, keys, sorted, index);
+
+                size_t chunk = (n + nThreads - 1)/nThreads;
+                for(G4int t = 0; t < nThreads; ++t) {
+                    size_t b = std::min(n, t*chunk);
+                    size_t e = std::min(n, b + chunk);
+                    tasks[t].begin = &sorted[0] + b;
+                    tasks[t].end = &sorted[0] + e;
+                    tasks[t].index = &index[0] + b;
+                    tasks[t].rows.clear();
+                    tasks[t].nOutside = 0;
+                }
+                workers.Start();
+
+                //----- Read the next batch while this one is located
+                size_t next = reader.Read(raw, batchSize_);
+                workers.Wait();
+
+                for(G4int t = 0; t < nThreads; ++t) {
+                    const std::string& rows = tasks[t].rows;
+                    if(isWritten) isWritten = std::fwrite(rows.data(), 1, rows.size(), pOut) == rows.size();
+                    nOutside += tasks[t].nOutside;
+                }
+                nPoints += n;
+                n = next;
+            }
+
+            if(pOut == stdout) {
+                if(std::fflush(pOut) != 0) isWritten = false;
+            }
+            else if(std::fclose(pOut) != 0) {
+                isWritten = false;
+            }
+
+            if(!isWritten) {
+                G4cerr<<"gdmlview: error writing location output file \""<<outFile<<"\""<<G4endl;
+                return false;
+            }
+
+            if(reader.Failed()) {
+                G4cerr<<"gdmlview: unreadable point data in \""<<inFile<<"\"";
+                if(reader.GetLineNumber()) G4cerr<<" at line "<<reader.GetLineNumber();
+                G4cerr<<", stopped after "<<nPoints<<" points"<<G4endl;
+                return false;
+            }
+
+            G4double seconds = (latte::profile::WallClockNs() - start)*1.0e-9;
+            log<<"gdmlview: located "<<nPoints<<" points ("<<nOutside<<" outside the world) in "
+                  <<seconds<<" s on "<<nThreads<<" threads"<<G4endl;
+            return true;
+        }
+
+    } // namespace geometry
+} // namespace latte
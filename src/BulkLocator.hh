@@ -0,0 +1,60 @@
+#ifndef BULKLOCATOR_HH
+#define BULKLOCATOR_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Locates large point files in the loaded world, e.g. field map
+//              grids or survey points, writing volume, copy number, material
+//              and full path for every point.
+//
+//              Points are read in batches, sorted along a Morton curve, and
+//              split into contiguous runs over a pool of threads, each with
+//              its own navigator. Neighbouring points mostly share a volume,
+//              so the relative search rarely has to climb the history.
+//
+//              Input is CSV/whitespace separated "x y z" in mm, or raw native
+//              float64 (.f64, .bin) or float32 (.f32) triples. Output is CSV
+//              in spatial order, keyed by the point's index in the input.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+
+#include <iosfwd>
+#include <string>
+
+namespace latte {
+    namespace geometry {
+
+        class PointLocator;
+
+        class BulkLocator
+        {
+            public:
+                BulkLocator(PointLocator* locator);
+                ~BulkLocator();
+
+                //----- 0 uses every core
+                void SetThreads(G4int nThreads) {nThreads_ = nThreads > 0 ? nThreads : 0;}
+                void SetBatchSize(size_t nPoints) {batchSize_ = nPoints > 0 ? nPoints : 1;}
+
+                //----- Locate every point of inFile, writing to outFile, or
+                // stdout for "-". False if either file cannot be used, or
+                // writing fails. Notes go to G4cerr when writing to stdout.
+                bool Run(const std::string& inFile, const std::string& outFile);
+
+            private:
+                G4int NumberOfThreads(std::ostream& log);
+
+            private:
+                PointLocator* pLocator_;
+                G4int         nThreads_;
+                size_t        batchSize_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // BULKLOCATOR_HH
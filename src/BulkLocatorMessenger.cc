@@ -0,0 +1,71 @@
+#include "BulkLocatorMessenger.hh"
+
+#include "BulkLocator.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+namespace latte {
+    namespace geometry {
+
+        BulkLocatorMessenger::BulkLocatorMessenger(BulkLocator* messengedObject) : G4UImessenger(),
+        pMessengedLocator_(messengedObject), pDirectory_(0), pRunCmd_(0), pThreadsCmd_(0), pBatchSizeCmd_(0)
+        {
+            //----- Default Constructor
+            pDirectory_ = new G4UIdirectory("/gdmlview/locate/");
+            pDirectory_->SetGuidance("Volume, copy number and material lookup for files of points");
+
+            pRunCmd_ = new G4UIcommand("/gdmlview/locate/run",this);
+            pRunCmd_->SetGuidance("locate every point of a file, writing one CSV row per point");
+            pRunCmd_->SetGuidance("points are text \"x y z\" rows in mm, or raw .f64/.bin/.f32 triples");
+            pRunCmd_->SetGuidance("rows are written in spatial order, keyed by input index; \"-\" is stdout");
+            pRunCmd_->SetParameter(new G4UIparameter("points", 's', false));
+            G4UIparameter* output = new G4UIparameter("output", 's', true);
+            output->SetDefaultValue("-");
+            pRunCmd_->SetParameter(output);
+            pRunCmd_->AvailableForStates(G4State_Idle);
+
+            pThreadsCmd_ = new G4UIcmdWithAnInteger("/gdmlview/locate/threads",this);
+            pThreadsCmd_->SetGuidance("number of lookup threads, 0 for one per core");
+            pThreadsCmd_->SetParameterName("n", false);
+            pThreadsCmd_->SetRange("n >= 0");
+            pThreadsCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pBatchSizeCmd_ = new G4UIcmdWithAnInteger("/gdmlview/locate/batchSize",this);
+            pBatchSizeCmd_->SetGuidance("number of points read, sorted and located together");
+            pBatchSizeCmd_->SetParameterName("n", false);
+            pBatchSizeCmd_->SetRange("n > 0");
+            pBatchSizeCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        BulkLocatorMessenger::~BulkLocatorMessenger()
+        {
+            //----- Destructor
+            delete pBatchSizeCmd_;
+            delete pThreadsCmd_;
+            delete pRunCmd_;
+            delete pDirectory_;
+        }
+
+
+        void BulkLocatorMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pRunCmd_) {
+                std::istringstream is(args);
+                std::string points, output("-");
+                is>>points>>output;
+                pMessengedLocator_->Run(points, output);
+            }
+            else if ( cmd == pThreadsCmd_) {
+                pMessengedLocator_->SetThreads(pThreadsCmd_->GetNewIntValue(args));
+            }
+            else if ( cmd == pBatchSizeCmd_) {
+                pMessengedLocator_->SetBatchSize(pBatchSizeCmd_->GetNewIntValue(args));
+            }
+        }
+
+    } // namespace geometry
+} // namespace latte
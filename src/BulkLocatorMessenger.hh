@@ -0,0 +1,43 @@
+#ifndef BULKLOCATORMESSENGER_HH
+#define BULKLOCATORMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for BulkLocator
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+
+namespace latte {
+    namespace geometry {
+
+        class BulkLocator;
+
+        class BulkLocatorMessenger : public G4UImessenger
+        {
+            public:
+                BulkLocatorMessenger(BulkLocator* messengedObject);
+                virtual ~BulkLocatorMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                BulkLocator*          pMessengedLocator_;
+
+                G4UIdirectory*        pDirectory_;
+                G4UIcommand*          pRunCmd_;
+                G4UIcmdWithAnInteger* pThreadsCmd_;
+                G4UIcmdWithAnInteger* pBatchSizeCmd_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // BULKLOCATORMESSENGER_HH
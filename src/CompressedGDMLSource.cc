@@ -0,0 +1,361 @@
+#include "CompressedGDMLSource.hh"
+
+#include "PosixIO.hh"
+
+#include "globals.hh"
+
+#include <boost/bind.hpp>
+#include <zlib.h>
+#ifdef GDMLVIEW_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include <signal.h>
+#include <time.h>
+#include <cctype>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+namespace {
+    bool HasSuffix(const std::string& s, const char* suffix)
+    {
+        std::string x(suffix);
+        return s.size() >= x.size() && s.compare(s.size() - x.size(), x.size(), x) == 0;
+    }
+
+    //----- Sequential reader over plain or compressed files
+    class InputFile
+    {
+        public:
+            virtual ~InputFile() {;}
+
+            //----- Bytes read, 0 at end, -1 on error
+            virtual long Read(char* buffer, size_t size) = 0;
+    };
+
+    class GzipInputFile : public InputFile
+    {
+        public:
+            //----- zlib also reads uncompressed files transparently
+            GzipInputFile(const std::string& fileName) : file_(gzopen(fileName.c_str(), "rb"))
+            {
+                if(file_) gzbuffer(file_, 1 << 17);
+            }
+
+            virtual ~GzipInputFile()
+            {
+                if(file_) gzclose(file_);
+            }
+
+            bool IsOpen() const {return file_ != 0;}
+
+            virtual long Read(char* buffer, size_t size)
+            {
+                return gzread(file_, buffer, static_cast<unsigned>(size));
+            }
+
+        private:
+            gzFile file_;
+    };
+
+#ifdef GDMLVIEW_HAVE_ZSTD
+    class ZstdInputFile : public InputFile
+    {
+        public:
+            ZstdInputFile(const std::string& fileName) : pFile_(std::fopen(fileName.c_str(), "rb")),
+            pContext_(ZSTD_createDStream()), in_(ZSTD_DStreamInSize()), input_(), done_(false)
+            {
+                ZSTD_initDStream(pContext_);
+                input_.src = &in_[0];
+                input_.size = 0;
+                input_.pos = 0;
+            }
+
+            virtual ~ZstdInputFile()
+            {
+                ZSTD_freeDStream(pContext_);
+                if(pFile_) std::fclose(pFile_);
+            }
+
+            bool IsOpen() const {return pFile_ != 0;}
+
+            virtual long Read(char* buffer, size_t size)
+            {
+                ZSTD_outBuffer output = {buffer, size, 0};
+                while(output.pos == 0) {
+                    if(input_.pos == input_.size) {
+                        if(done_) return 0;
+                        input_.size = std::fread(&in_[0], 1, in_.size(), pFile_);
+                        input_.pos = 0;
+                        if(input_.size == 0) {
+                            done_ = true;
+                            return std::ferror(pFile_) ? -1 : 0;
+                        }
+                    }
+                    size_t ret = ZSTD_decompressStream(pContext_, &output, &input_);
+                    if(ZSTD_isError(ret)) return -1;
+                }
+                return static_cast<long>(output.pos);
+            }
+
+        private:
+            FILE*             pFile_;
+            ZSTD_DStream*     pContext_;
+            std::vector<char> in_;
+            ZSTD_inBuffer     input_;
+            bool              done_;
+    };
+#endif
+
+    InputFile* OpenInputFile(const std::string& fileName)
+    {
+        if(HasSuffix(fileName, ".zst")) {
+#ifdef GDMLVIEW_HAVE_ZSTD
+            std::auto_ptr<ZstdInputFile> zst(new ZstdInputFile(fileName));
+            return zst->IsOpen() ? zst.release() : 0;
+#else
+            G4cerr<<"gdmlview: built without zstd, cannot read \""<<fileName<<"\""<<G4endl;
+            return 0;
+#endif
+        }
+        std::auto_ptr<GzipInputFile> gz(new GzipInputFile(fileName));
+        return gz->IsOpen() ? gz.release() : 0;
+    }
+
+    //----- Apply rename to the name attribute of every complete <file>
+    // tag in text. Returns text with the names replaced.
+    template<typename Rename>
+    std::string RenameModules(const std::string& text, Rename& rename)
+    {
+        std::string out;
+        std::string::size_type done = 0;
+        std::string::size_type tag;
+        while((tag = text.find("<file", done)) != std::string::npos) {
+            std::string::size_type end = text.find('>', tag);
+            if(end == std::string::npos) break;
+            if(tag + 5 == end || !std::isspace(text[tag + 5])) {
+                out.append(text, done, tag + 5 - done);
+                done = tag + 5;
+                continue;
+            }
+
+            //----- "name", not "volname"
+            std::string::size_type attr = tag + 5;
+            while((attr = text.find("name", attr)) != std::string::npos && attr < end && !std::isspace(text[attr - 1])) {
+                attr += 4;
+            }
+            if(attr >= end) attr = std::string::npos;
+            std::string::size_type eq = attr == std::string::npos ? attr : text.find('=', attr + 4);
+            std::string::size_type open = eq == std::string::npos ? eq : text.find_first_of("\"'", eq + 1);
+            std::string::size_type close = open == std::string::npos ? open : text.find(text[open], open + 1);
+
+            if(close == std::string::npos || close > end) {
+                out.append(text, done, end + 1 - done);
+                done = end + 1;
+                continue;
+            }
+
+            out.append(text, done, open + 1 - done);
+            out.append(rename(text.substr(open + 1, close - open - 1)));
+            done = close;
+        }
+        out.append(text, done, std::string::npos);
+        return out;
+    }
+
+    //----- Replaces module names with what the parser should read
+    template<typename Source>
+    struct ModuleOpener
+    {
+        ModuleOpener(Source* s, std::string (Source::*o)(const std::string&)) : source(s), open(o) {;}
+
+        std::string operator()(const std::string& name)
+        {
+            return (source->*open)(name);
+        }
+
+        Source* source;
+        std::string (Source::*open)(const std::string&);
+    };
+
+    //----- Text up to and including the last '>', so that no tag is split
+    std::string::size_type CompleteTags(const std::string& text)
+    {
+        std::string::size_type last = text.rfind('>');
+        return last == std::string::npos ? 0 : last + 1;
+    }
+
+    //----- An anonymous in-memory file. Unlike a pipe, every open of its
+    // /dev/fd name starts from the beginning. -1 where there are none.
+    int OpenMemoryFile(const std::string& name)
+    {
+#if defined(__linux__) && defined(SYS_memfd_create)
+        return static_cast<int>(::syscall(SYS_memfd_create, name.c_str(), 0));
+#else
+        (void)name;
+        return -1;
+#endif
+    }
+
+    std::string DeviceName(int fd)
+    {
+        std::ostringstream name;
+        name<<"/dev/fd/"<<fd;
+        return name.str();
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        CompressedGDMLSource::CompressedGDMLSource() : mutex_(), closing_(false), readFds_(), modules_(),
+        pumps_()
+        {;}
+
+
+        CompressedGDMLSource::~CompressedGDMLSource()
+        {
+            //----- Closing the read ends unblocks any pump whose pipe was
+            // never, or not fully, read
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                closing_ = true;
+                for(std::vector<int>::const_iterator fd = readFds_.begin(); fd != readFds_.end(); ++fd) {
+                    ::close(*fd);
+                }
+                readFds_.clear();
+            }
+            pumps_.join_all();
+        }
+
+
+        bool CompressedGDMLSource::IsCompressed(const std::string& fileName)
+        {
+            return HasSuffix(fileName, ".gz") || HasSuffix(fileName, ".zst");
+        }
+
+
+        std::string CompressedGDMLSource::Open(const std::string& fileName)
+        {
+            //----- Plain files are left to the parser, so they are read only
+            // once. Compressed modules are only looked for below a
+            // compressed file, whose text passes through here anyway.
+            return IsCompressed(fileName) ? this->OpenPipe(fileName) : fileName;
+        }
+
+
+        std::string CompressedGDMLSource::OpenModule(const std::string& fileName)
+        {
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                if(closing_) return fileName;
+                std::map<std::string, std::string>::const_iterator known = modules_.find(fileName);
+                if(known != modules_.end()) return known->second;
+
+                //----- Modules including each other are left to the parser
+                modules_[fileName] = fileName;
+            }
+
+            int fd = OpenMemoryFile(fileName);
+            if(fd < 0) {
+                boost::mutex::scoped_lock lock(mutex_);
+                modules_.erase(fileName);
+            }
+            if(fd < 0) return this->OpenPipe(fileName);
+
+            //----- On error the parser is given the module itself, and
+            // reports it as it would for a plain file
+            bool ok = this->Copy(fileName, fd);
+
+            boost::mutex::scoped_lock lock(mutex_);
+            if(!ok) {
+                ::close(fd);
+                return fileName;
+            }
+            readFds_.push_back(fd);
+            return modules_[fileName] = DeviceName(fd);
+        }
+
+
+        std::string CompressedGDMLSource::OpenPipe(const std::string& fileName)
+        {
+            //----- The pump is started under mutex_, so that once the
+            // destructor has seen it through closing_, join_all cannot
+            // start until it is in the group
+            int fds[2];
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                if(closing_) return fileName;
+                if(::pipe(fds) < 0) {
+                    G4cerr<<"gdmlview: cannot create pipe for \""<<fileName<<"\""<<G4endl;
+                    return fileName;
+                }
+                readFds_.push_back(fds[0]);
+                pumps_.create_thread(boost::bind(&CompressedGDMLSource::Pump, this, fileName, fds[1]));
+            }
+            return DeviceName(fds[0]);
+        }
+
+
+        void CompressedGDMLSource::Pump(const std::string fileName, int writeFd)
+        {
+            //----- If the parser stops reading early, writes fail with
+            // EPIPE. Blocking SIGPIPE on this thread only keeps it from
+            // ending the process, without changing how any other write
+            // in the process behaves.
+            sigset_t pipeSignal;
+            sigemptyset(&pipeSignal);
+            sigaddset(&pipeSignal, SIGPIPE);
+            pthread_sigmask(SIG_BLOCK, &pipeSignal, 0);
+
+            bool ok = this->Copy(fileName, writeFd);
+            ::close(writeFd);
+
+            //----- Consume the SIGPIPE raised for this thread, if any
+            if(!ok) {
+                timespec now = {0, 0};
+                sigtimedwait(&pipeSignal, 0, &now);
+            }
+        }
+
+
+        bool CompressedGDMLSource::Copy(const std::string& fileName, int fd)
+        {
+            //----- Decompress fileName into fd, rewriting module names. False
+            // if it cannot be read or fd cannot be written.
+            std::auto_ptr<InputFile> in(OpenInputFile(fileName));
+            if(!in.get()) {
+                G4cerr<<"gdmlview: cannot open \""<<fileName<<"\""<<G4endl;
+                return false;
+            }
+
+            std::string text;
+            std::vector<char> buffer(1 << 17);
+            long n(0);
+            bool ok = true;
+            while(ok && (n = in->Read(&buffer[0], buffer.size())) > 0) {
+                text.append(&buffer[0], n);
+                std::string::size_type complete = CompleteTags(text);
+                ok = latte::io::WriteAll(fd, this->RewriteModules(text.substr(0, complete)));
+                text.erase(0, complete);
+            }
+            if(n < 0) G4cerr<<"gdmlview: error decompressing \""<<fileName<<"\""<<G4endl;
+            if(ok) ok = latte::io::WriteAll(fd, this->RewriteModules(text));
+            return ok && n >= 0;
+        }
+
+
+        std::string CompressedGDMLSource::RewriteModules(const std::string& text)
+        {
+            ModuleOpener<CompressedGDMLSource> opener(this, &CompressedGDMLSource::OpenModule);
+            return RenameModules(text, opener);
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,69 @@
+#ifndef COMPRESSEDGDMLSOURCE_HH
+#define COMPRESSEDGDMLSOURCE_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Feeds gzip (.gz) and, if built with zstd, .zst compressed
+//              GDML to G4GDMLParser, which only reads from file names.
+//
+//              A compressed file is decompressed by a thread into a pipe,
+//              and the parser is given "/dev/fd/N" for the read end, so
+//              decompression overlaps parsing and nothing is written to
+//              disk. Plain files are given to the parser as they are.
+//
+//              Module names in <file name="..."/> of a compressed file are
+//              rewritten on the way through, so its modules, and theirs,
+//              may be compressed too. Each module is read once, however
+//              often it is included, into an in-memory file that the parser
+//              can open any number of times. Where there are no in-memory
+//              files (outside Linux), every inclusion gets its own pipe.
+//
+//              Pipes and module files stay readable until the source is
+//              destroyed, which must not happen before G4GDMLParser::Read
+//              returns.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace latte {
+    namespace geometry {
+
+        class CompressedGDMLSource
+        {
+            public:
+                CompressedGDMLSource();
+                ~CompressedGDMLSource();
+
+                //----- Name the parser should read for fileName. That is
+                // fileName itself unless it is compressed.
+                std::string Open(const std::string& fileName);
+
+                static bool IsCompressed(const std::string& fileName);
+
+            private:
+                std::string OpenPipe(const std::string& fileName);
+                std::string OpenModule(const std::string& fileName);
+                void Pump(const std::string fileName, int writeFd);
+                bool Copy(const std::string& fileName, int fd);
+                std::string RewriteModules(const std::string& text);
+
+            private:
+                boost::mutex                       mutex_;
+                bool                               closing_;
+                std::vector<int>                   readFds_;
+                std::map<std::string, std::string> modules_;
+                boost::thread_group                pumps_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // COMPRESSEDGDMLSOURCE_HH
@@ -2,6 +2,7 @@
 #include "DetectorConstructorMessenger.hh"
 
 #include "IGeometryConstructor.hh"
+#include "PointLocator.hh"
 
 #include "G4RunManager.hh"
 #include "G4GeometryManager.hh"
@@ -18,7 +19,7 @@ namespace latte {
     namespace geometry {
 
         DetectorConstructor::DetectorConstructor() : G4VUserDetectorConstruction(),
-        pMessenger_(0), pGeometryImpl_(0)
+        pMessenger_(0), pGeometryImpl_(0), isPrefetched_(false), locators_()
         {
             //Default Constructor
             pMessenger_ = new DetectorConstructorMessenger(this);
@@ -36,11 +37,27 @@ namespace latte {
         G4VPhysicalVolume* DetectorConstructor::Construct()
         {
             //Construct physical volume for world and return it
-            this->CleanGeometry();
+            //A prefetched geometry is already in the cleaned stores
+            if(!isPrefetched_) this->CleanGeometry();
+            isPrefetched_ = false;
             return pGeometryImpl_->Construct();
         }
 
 
+        void DetectorConstructor::Prefetch()
+        {
+            this->CleanGeometry();
+            pGeometryImpl_->Prefetch();
+            isPrefetched_ = true;
+        }
+
+
+        void DetectorConstructor::Attach(PointLocator* locator)
+        {
+            locators_.push_back(locator);
+        }
+
+
         void DetectorConstructor::UpdateDetector()
         {
             //----- Refresh detector geometry
@@ -50,8 +67,11 @@ namespace latte {
 
         void DetectorConstructor::CleanGeometry()
         {
-            //----- clean the geometry tree
+            //----- clean the geometry tree, once nothing will navigate it
             //
+            for(std::vector<PointLocator*>::const_iterator locator = locators_.begin(); locator != locators_.end(); ++locator) {
+                (*locator)->Invalidate();
+            }
             G4GeometryManager::GetInstance()->OpenGeometry();
             G4PhysicalVolumeStore::GetInstance()->Clean();
             G4LogicalVolumeStore::GetInstance()->Clean();
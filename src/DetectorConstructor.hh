@@ -13,11 +13,14 @@
 
 #include "G4VUserDetectorConstruction.hh"
 
+#include <vector>
+
 namespace latte {
     namespace geometry {
 
         class IGeometryConstructor;
         class DetectorConstructorMessenger;
+        class PointLocator;
 
         class DetectorConstructor : public G4VUserDetectorConstruction
         {
@@ -32,6 +35,14 @@ namespace latte {
                 //----- Update geometry when changed
                 void UpdateDetector();
 
+                //----- Start building the geometry now, on a background
+                // thread if the implementation can, for the next Construct()
+                void Prefetch();
+
+                //----- Invalidate locator whenever the geometry is cleaned,
+                // so it never navigates deleted volumes
+                void Attach(PointLocator* locator);
+
             private:
                 //Clean geometry tree
                 void CleanGeometry();
@@ -39,6 +50,8 @@ namespace latte {
             private:
                 DetectorConstructorMessenger* pMessenger_;
                 IGeometryConstructor*         pGeometryImpl_;
+                bool                          isPrefetched_;
+                std::vector<PointLocator*>    locators_;
         };
 
     } // namespace geometry
@@ -1,37 +1,239 @@
 #include "GDMLGeometryConstructor.hh"
 #include "GDMLGeometryConstructorMessenger.hh"
+#include "VolumeIndexMessenger.hh"
+#include "MassCalculatorMessenger.hh"
+#include "GeometryStatsMessenger.hh"
+#include "CompressedGDMLSource.hh"
+#include "ThreadOutputBuffer.hh"
+#include "StartupTimeline.hh"
 
 #include "G4GDMLParser.hh"
 #include "G4LogicalVolume.hh"
+#include "G4GeometryManager.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4NistManager.hh"
+#include "G4UnitsTable.hh"
+#include "G4StateManager.hh"
+#include "G4VExceptionHandler.hh"
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace {
+    //----- Unwinds the builder out of the parser after a fatal exception
+    struct BuildAborted {};
+
+    G4bool IsFatal(G4ExceptionSeverity severity)
+    {
+        return severity == FatalException || severity == FatalErrorInArgument;
+    }
+}
 
 namespace latte
 {
+    //----- Stands in for the run manager's exception handler while the
+    // builder runs. A fatal exception on the builder thread is recorded and
+    // unwinds the build, then raised again on the main thread by Wait().
+    // Aborting on the builder would lose its held output and change the
+    // application state under the main thread. Everything else is passed
+    // to the handler it replaced.
+    class BuilderExceptionHandler : public G4VExceptionHandler
+    {
+        public:
+            BuilderExceptionHandler(G4VExceptionHandler* previous) : G4VExceptionHandler(), pPrevious_(previous),
+            mutex_(), builder_(), isFailed_(false), origin_(), code_(), severity_(JustWarning), description_()
+            {;}
+
+            virtual ~BuilderExceptionHandler()
+            {
+                this->Restore();
+            }
+
+            //----- Call from the builder thread before it does anything
+            void Capture()
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                builder_ = boost::this_thread::get_id();
+            }
 
-    GDMLGeometryConstructor::GDMLGeometryConstructor() : latte::geometry::IGeometryConstructor(), gdmlFile_(), setupName_("Default"), pMessenger_(0)
+            //----- Put back the handler this one replaced
+            void Restore()
+            {
+                G4StateManager* stateManager = G4StateManager::GetStateManager();
+                if(stateManager->GetExceptionHandler() == this) stateManager->SetExceptionHandler(pPrevious_);
+            }
+
+            //----- Raise the builder's fatal exception, if any, on this thread
+            void Rethrow() const
+            {
+                if(isFailed_) G4Exception(origin_.c_str(), code_.c_str(), severity_, description_.c_str());
+            }
+
+            virtual G4bool Notify(const char* originOfException, const char* exceptionCode,
+                    G4ExceptionSeverity severity, const char* description)
+            {
+                bool isBuilder(false);
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    isBuilder = boost::this_thread::get_id() == builder_;
+                }
+
+                if(isBuilder && IsFatal(severity)) {
+                    isFailed_ = true;
+                    origin_ = originOfException;
+                    code_ = exceptionCode;
+                    severity_ = severity;
+                    description_ = description;
+                    throw BuildAborted();
+                }
+
+                if(pPrevious_) return pPrevious_->Notify(originOfException, exceptionCode, severity, description);
+                G4cerr<<originOfException<<" ("<<exceptionCode<<"): "<<description<<G4endl;
+                return IsFatal(severity);
+            }
+
+        private:
+            G4VExceptionHandler* pPrevious_;
+            boost::mutex         mutex_;
+            boost::thread::id    builder_;
+            bool                 isFailed_;
+            std::string          origin_;
+            std::string          code_;
+            G4ExceptionSeverity  severity_;
+            std::string          description_;
+    };
+
+
+    GDMLGeometryConstructor::GDMLGeometryConstructor() : latte::geometry::IGeometryConstructor(), gdmlFile_(), setupName_("Default"), pMessenger_(0),
+    index_(), pIndexMessenger_(0), mass_(), pMassMessenger_(0), pStatsMessenger_(0), pParser_(0), pBuilder_(0), pBuilderOutput_(0),
+    pBuilderHandler_(0), pWorld_(0)
     {
         //----- Default constructor
         pMessenger_ = new GDMLGeometryConstructorMessenger(this);
+        pIndexMessenger_ = new latte::geometry::VolumeIndexMessenger(&index_);
+        pMassMessenger_ = new latte::geometry::MassCalculatorMessenger(&mass_, &index_);
+        pStatsMessenger_ = new latte::geometry::GeometryStatsMessenger(&index_);
     }
 
     GDMLGeometryConstructor::~GDMLGeometryConstructor()
     {
         //----- Destructor
+        this->Wait();
+        delete pParser_;
+        delete pStatsMessenger_;
+        delete pMassMessenger_;
+        delete pIndexMessenger_;
         delete pMessenger_;
     }
 
     G4VPhysicalVolume* GDMLGeometryConstructor::Construct()
     {
-        //----- Construct world volume
-        //parser is only needed for the lifetime of this method.
-        G4GDMLParser parser_;
-        parser_.Read(gdmlFile_);
+        //----- Construct world volume, or collect the prefetched one
+        if(pBuilder_) {
+            this->Wait();
+        }
+        else {
+            pParser_ = new G4GDMLParser;
+            this->Build(false);
+        }
+
+        //parser is only needed until the world is constructed.
+        delete pParser_;
+        pParser_ = 0;
+        return pWorld_;
+    }
+
+    void GDMLGeometryConstructor::Prefetch()
+    {
+        this->Wait();
+        delete pParser_;
+
+        //----- Everything the parser would otherwise create lazily on the
+        // builder thread, and which the main thread may touch meanwhile:
+        // UI commands registered by the parser and the NIST manager, the
+        // units table and the geometry tolerance.
+        pParser_ = new G4GDMLParser;
+        G4NistManager::Instance();
+        G4UnitDefinition::GetValueOf("mm");
+        G4GeometryTolerance::GetInstance();
+
+        pBuilderOutput_ = new ThreadOutputBuffer;
+        pBuilderHandler_ = new BuilderExceptionHandler(G4StateManager::GetStateManager()->GetExceptionHandler());
+        pBuilder_ = new boost::thread(boost::bind(&GDMLGeometryConstructor::BuildInBackground, this));
+    }
+
+    void GDMLGeometryConstructor::BuildInBackground()
+    {
+        //----- A fatal exception is raised again by Wait()
+        pBuilderHandler_->Capture();
+        try {
+            this->Build(true);
+        }
+        catch(const BuildAborted&) {
+            pWorld_ = 0;
+        }
+    }
+
+    void GDMLGeometryConstructor::Build(bool isBackground)
+    {
+        if(isBackground) pBuilderOutput_->Capture();
+        const char* lane(isBackground ? "geometry" : "main");
+
+        {
+            latte::profile::StartupTimeline::Phase phase(lane, "parse gdml");
+            //source must outlive the Read, as it feeds any compressed files
+            latte::geometry::CompressedGDMLSource source;
+            pParser_->Read(source.Open(gdmlFile_));
+        }
 
-        G4VPhysicalVolume* pWorld = parser_.GetWorldVolume(setupName_);
+        pWorld_ = pParser_->GetWorldVolume(setupName_);
         //----- GDML parser makes world invisible, this is a hack to make it
         //visible again...
-        G4LogicalVolume* pWorldLogical = pWorld->GetLogicalVolume();
+        G4LogicalVolume* pWorldLogical = pWorld_->GetLogicalVolume();
         pWorldLogical->SetVisAttributes(0);
-        return pWorld;
+
+        //----- Index names and paths now, so lookups never walk the stores,
+        // and drop masses cached for the previous geometry
+        {
+            latte::profile::StartupTimeline::Phase phase(lane, "index volumes");
+            index_.Build(pWorld_);
+            mass_.Clear();
+        }
+
+        //----- Voxelize, in the background while the main thread is busy
+        // elsewhere, so that --stats, --locate and socket queries navigate
+        // with voxels before any run. Rebuilt geometries are closed too,
+        // so both paths leave the same state. The run manager reopens and
+        // closes the geometry again at the next beamOn, as it does for any
+        // newly defined world, and offers no way to skip that.
+        {
+            latte::profile::StartupTimeline::Phase phase(lane, "close geometry");
+            G4GeometryManager::GetInstance()->CloseGeometry(true, false, pWorld_);
+        }
+    }
+
+    void GDMLGeometryConstructor::Wait()
+    {
+        //----- Join the builder, if any, and replay its output here
+        if(!pBuilder_) return;
+        {
+            latte::profile::StartupTimeline::Phase phase("main", "wait for geometry");
+            pBuilder_->join();
+        }
+        delete pBuilder_;
+        pBuilder_ = 0;
+
+        pBuilderOutput_->Release();
+        delete pBuilderOutput_;
+        pBuilderOutput_ = 0;
+
+        //----- Output first, so a fatal exception follows what led to it
+        BuilderExceptionHandler* handler = pBuilderHandler_;
+        pBuilderHandler_ = 0;
+        handler->Restore();
+        handler->Rethrow();
+        delete handler;
     }
 
     void GDMLGeometryConstructor::Read(const G4String& gdmlFile)
@@ -2,10 +2,24 @@
 #define GDMLGEOMETRYCONSTRUCTOR_HH
 
 #include "IGeometryConstructor.hh"
+#include "VolumeIndex.hh"
+#include "MassCalculator.hh"
 #include "G4String.hh"
 
+class G4GDMLParser;
+namespace boost {
+    class thread;
+}
+
 namespace latte {
     class GDMLGeometryConstructorMessenger;
+    class ThreadOutputBuffer;
+    class BuilderExceptionHandler;
+    namespace geometry {
+        class VolumeIndexMessenger;
+        class MassCalculatorMessenger;
+        class GeometryStatsMessenger;
+    }
 
     class GDMLGeometryConstructor : public latte::geometry::IGeometryConstructor
     {
@@ -15,13 +29,38 @@ namespace latte {
 
             G4VPhysicalVolume* Construct();
 
+            //----- Parse, index and close the geometry on a background
+            // thread, collected by the next Construct(). Create the run
+            // manager first: its kernel replaces any exception handler
+            // installed before it, the builder's included. The first run
+            // voxelizes again, see Build().
+            void Prefetch();
+
             void Read(const G4String& gdmlFile);
             void SelectSetup(const G4String& setupName);
 
+            //----- Name and path lookup for the last constructed world
+            const latte::geometry::VolumeIndex& GetVolumeIndex() const {return index_;}
+
+        private:
+            void Build(bool isBackground);
+            void BuildInBackground();
+            void Wait();
+
         private:
             G4String gdmlFile_;
             G4String setupName_;
             GDMLGeometryConstructorMessenger* pMessenger_;
+            latte::geometry::VolumeIndex index_;
+            latte::geometry::VolumeIndexMessenger* pIndexMessenger_;
+            latte::geometry::MassCalculator mass_;
+            latte::geometry::MassCalculatorMessenger* pMassMessenger_;
+            latte::geometry::GeometryStatsMessenger* pStatsMessenger_;
+            G4GDMLParser*       pParser_;
+            boost::thread*      pBuilder_;
+            ThreadOutputBuffer* pBuilderOutput_;
+            BuilderExceptionHandler* pBuilderHandler_;
+            G4VPhysicalVolume*  pWorld_;
     };
 
 }
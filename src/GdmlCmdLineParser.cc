@@ -12,6 +12,7 @@
 #include <string>
 #include <cstdlib>
 #include <iostream>
+#include <glob.h>
 
 GdmlCmdLineParser::GdmlCmdLineParser(int argc, char** argv) : argC_(argc), argV_(argv), options_("gdmlview options"), pos_options_(), variables_()
 {
@@ -19,7 +20,21 @@ GdmlCmdLineParser::GdmlCmdLineParser(int argc, char** argv) : argC_(argc), argV_
     options_.add_options()
         ("help,h", "print help message")
         ("shell,s",bpo::value<std::string>()->default_value("qt"), "start interactive session")
-        ("gdml-file,f",bpo::value<std::string>(), "open GDML file");
+        ("socket",bpo::value<std::string>(), "socket path for the socket shell (default: $GDMLVIEW_SOCKET or /tmp/gdmlview-<uid>.sock)")
+        ("gdml-file,f",bpo::value<std::vector<std::string> >()->composing(), "open GDML file, or with --validate, files and globs")
+        ("profile,p",bpo::value<std::string>(), "profile navigation per volume, writing flame graph stacks to file")
+        ("locate",bpo::value<std::string>(), "batch mode: locate every point in file and exit")
+        ("locate-output",bpo::value<std::string>()->default_value("-"), "CSV output of --locate (default: stdout)")
+        ("seed",bpo::value<uint64_t>(), "master random seed (default: from system time)")
+        ("job-index",bpo::value<uint64_t>(), "derive an independent random stream for this job from the master seed")
+        ("timeline", "print when each startup phase ran, and on which thread")
+        ("stats", "batch mode: print geometry statistics and estimated memory, and exit")
+        ("stats-top",bpo::value<int>()->default_value(10), "logical volumes holding the most memory to list with --stats and --validate")
+        ("validate", "batch mode: load, overlap check and summarize every GDML file")
+        ("report",bpo::value<std::string>()->default_value("-"), "JSON report file of --validate (default: stdout)")
+        ("jobs,j",bpo::value<int>()->default_value(0), "worker processes for --validate (default: one per core)")
+        ("validate-timeout",bpo::value<int>()->default_value(0), "seconds before a --validate worker is killed (default: no limit)")
+        ("overlap-resolution",bpo::value<int>()->default_value(1000), "surface points per volume in the --validate overlap check");
 
 
     pos_options_.add("gdml-file", -1);
@@ -51,7 +66,29 @@ void GdmlCmdLineParser::parse()
 
 std::string GdmlCmdLineParser::gdml_file() const
 {
-    return variables_["gdml-file"].as<std::string>();
+    //----- The first file given, throws bad_any_cast if none
+    return variables_["gdml-file"].as<std::vector<std::string> >().at(0);
+}
+
+std::vector<std::string> GdmlCmdLineParser::gdml_files() const
+{
+    //----- All files given, with globs expanded for shells that did not,
+    // e.g. when quoted in CI scripts. Unmatched patterns are kept as is.
+    std::vector<std::string> files;
+    if(!variables_.count("gdml-file")) return files;
+
+    const std::vector<std::string>& args = variables_["gdml-file"].as<std::vector<std::string> >();
+    for(std::vector<std::string>::const_iterator arg = args.begin(); arg != args.end(); ++arg) {
+        glob_t matches;
+        if(::glob(arg->c_str(), GLOB_NOCHECK, 0, &matches) == 0) {
+            files.insert(files.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+        }
+        else {
+            files.push_back(*arg);
+        }
+        ::globfree(&matches);
+    }
+    return files;
 }
 
 std::string GdmlCmdLineParser::shell_name() const
@@ -59,6 +96,90 @@ std::string GdmlCmdLineParser::shell_name() const
     return variables_["shell"].as<std::string>();
 }
 
+std::string GdmlCmdLineParser::profile_file() const
+{
+    //----- Empty if profiling was not requested
+    return variables_.count("profile") ? variables_["profile"].as<std::string>() : std::string();
+}
+
+std::string GdmlCmdLineParser::socket_path() const
+{
+    //----- Empty if the session should choose its default
+    return variables_.count("socket") ? variables_["socket"].as<std::string>() : std::string();
+}
+
+std::string GdmlCmdLineParser::locate_file() const
+{
+    //----- Empty unless running as a batch point locator
+    return variables_.count("locate") ? variables_["locate"].as<std::string>() : std::string();
+}
+
+std::string GdmlCmdLineParser::locate_output() const
+{
+    return variables_["locate-output"].as<std::string>();
+}
+
+bool GdmlCmdLineParser::timeline() const
+{
+    return variables_.count("timeline") != 0;
+}
+
+bool GdmlCmdLineParser::stats() const
+{
+    return variables_.count("stats") != 0;
+}
+
+int GdmlCmdLineParser::stats_top() const
+{
+    return variables_["stats-top"].as<int>();
+}
+
+bool GdmlCmdLineParser::validate() const
+{
+    return variables_.count("validate") != 0;
+}
+
+std::string GdmlCmdLineParser::report_file() const
+{
+    return variables_["report"].as<std::string>();
+}
+
+int GdmlCmdLineParser::jobs() const
+{
+    return variables_["jobs"].as<int>();
+}
+
+int GdmlCmdLineParser::validate_timeout() const
+{
+    return variables_["validate-timeout"].as<int>();
+}
+
+int GdmlCmdLineParser::overlap_resolution() const
+{
+    return variables_["overlap-resolution"].as<int>();
+}
+
+
+bool GdmlCmdLineParser::has_seed() const
+{
+    return variables_.count("seed") != 0;
+}
+
+uint64_t GdmlCmdLineParser::seed() const
+{
+    //----- Job streams derive from seed 0 if no master seed was given
+    return this->has_seed() ? variables_["seed"].as<uint64_t>() : 0;
+}
+
+bool GdmlCmdLineParser::has_job_index() const
+{
+    return variables_.count("job-index") != 0;
+}
+
+uint64_t GdmlCmdLineParser::job_index() const
+{
+    return variables_["job-index"].as<uint64_t>();
+}
 
 
 void GdmlCmdLineParser::display_help()
@@ -14,6 +14,9 @@
 
 
 #include <boost/program_options.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
 namespace bpo = boost::program_options;
 
 class GdmlCmdLineParser 
@@ -26,7 +29,25 @@ class GdmlCmdLineParser
 
         //----- Functions for clients to access information
         std::string gdml_file() const;
+        std::vector<std::string> gdml_files() const;
         std::string shell_name() const;
+        std::string profile_file() const;
+        std::string socket_path() const;
+        std::string locate_file() const;
+        std::string locate_output() const;
+        bool timeline() const;
+        bool stats() const;
+        int stats_top() const;
+        bool validate() const;
+        std::string report_file() const;
+        int jobs() const;
+        int validate_timeout() const;
+        int overlap_resolution() const;
+
+        bool has_seed() const;
+        uint64_t seed() const;
+        bool has_job_index() const;
+        uint64_t job_index() const;
 
     private:
         void display_help();
@@ -0,0 +1,416 @@
+#include "GeometryStats.hh"
+
+#include "JSON.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
+#include "G4SolidStore.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Isotope.hh"
+#include "G4IonisParamMat.hh"
+#include "G4SandiaTable.hh"
+#include "G4VisAttributes.hh"
+
+#include "G4Box.hh"
+#include "G4Tubs.hh"
+#include "G4CutTubs.hh"
+#include "G4Cons.hh"
+#include "G4Sphere.hh"
+#include "G4Orb.hh"
+#include "G4Trd.hh"
+#include "G4Trap.hh"
+#include "G4Para.hh"
+#include "G4Torus.hh"
+#include "G4Ellipsoid.hh"
+#include "G4EllipticalTube.hh"
+#include "G4EllipticalCone.hh"
+#include "G4Tet.hh"
+#include "G4Hype.hh"
+#include "G4Paraboloid.hh"
+#include "G4TwistedTubs.hh"
+#include "G4GenericTrap.hh"
+#include "G4Polycone.hh"
+#include "G4PolyconeSide.hh"
+#include "G4Polyhedra.hh"
+#include "G4PolyhedraSide.hh"
+#include "G4BooleanSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4ReflectedSolid.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace {
+    struct SolidSize
+    {
+        const char* type;
+        size_t      bytes;
+    };
+
+    //----- Solids sized by type alone. Booleans, displaced, reflected,
+    // tessellated and polycone-like solids are sized by their parts.
+    const SolidSize kSolidSizes[] = {
+        {"G4Box", sizeof(G4Box)},
+        {"G4Tubs", sizeof(G4Tubs)},
+        {"G4CutTubs", sizeof(G4CutTubs)},
+        {"G4Cons", sizeof(G4Cons)},
+        {"G4Sphere", sizeof(G4Sphere)},
+        {"G4Orb", sizeof(G4Orb)},
+        {"G4Trd", sizeof(G4Trd)},
+        {"G4Trap", sizeof(G4Trap)},
+        {"G4Para", sizeof(G4Para)},
+        {"G4Torus", sizeof(G4Torus)},
+        {"G4Ellipsoid", sizeof(G4Ellipsoid)},
+        {"G4EllipticalTube", sizeof(G4EllipticalTube)},
+        {"G4EllipticalCone", sizeof(G4EllipticalCone)},
+        {"G4Tet", sizeof(G4Tet)},
+        {"G4Hype", sizeof(G4Hype)},
+        {"G4Paraboloid", sizeof(G4Paraboloid)},
+        {"G4TwistedTubs", sizeof(G4TwistedTubs)},
+        {"G4GenericTrap", sizeof(G4GenericTrap)}
+    };
+
+    size_t SizeOfType(const std::string& type)
+    {
+        for(size_t i = 0; i < sizeof(kSolidSizes)/sizeof(kSolidSizes[0]); ++i) {
+            if(type == kSolidSizes[i].type) return kSolidSizes[i].bytes;
+        }
+        return sizeof(G4VSolid);
+    }
+
+    size_t PhysicalVolumeBytes(const G4VPhysicalVolume* pv)
+    {
+        if(pv->IsParameterised()) return sizeof(G4PVParameterised);
+        if(pv->IsReplicated()) return sizeof(G4PVReplica);
+        return sizeof(G4PVPlacement);
+    }
+
+    double Kilobytes(size_t bytes)
+    {
+        return static_cast<double>(bytes)/1024.0;
+    }
+
+    //----- "name value" row of a table, the name padded to width
+    template<typename T>
+    std::ostream& Row(std::ostream& os, size_t indent, int width, const std::string& name, const T& value)
+    {
+        return os<<std::string(indent, ' ')<<std::left<<std::setw(width)<<name<<" "<<std::right<<std::setw(12)<<value;
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        GeometryStats::GeometryStats() : worldName_(), solidTypes_(), nSolids_(0), nLogical_(0), nPhysical_(0),
+        nMaterials_(0), nFacets_(0), nTouchables_(0), maxDepth_(0), maxDaughters_(0), maxDaughtersVolume_(),
+        isVoxelized_(false), memory_(), volumes_(), below_(), depth_()
+        {;}
+
+
+        GeometryStats::~GeometryStats()
+        {;}
+
+
+        void GeometryStats::Clear()
+        {
+            worldName_.clear();
+            solidTypes_.clear();
+            nSolids_ = nLogical_ = nPhysical_ = nMaterials_ = nFacets_ = 0;
+            nTouchables_ = 0;
+            maxDepth_ = maxDaughters_ = 0;
+            maxDaughtersVolume_.clear();
+            isVoxelized_ = false;
+            memory_ = Memory();
+            volumes_.clear();
+            below_.clear();
+            depth_.clear();
+        }
+
+
+        void GeometryStats::Collect(G4VPhysicalVolume* world)
+        {
+            this->Clear();
+            if(!world) return;
+            worldName_ = world->GetName();
+
+            //----- Stores, each object once. Constituents of booleans are
+            // in the solid store themselves.
+            G4SolidStore* solids = G4SolidStore::GetInstance();
+            nSolids_ = solids->size();
+            for(G4SolidStore::const_iterator s = solids->begin(); s != solids->end(); ++s) {
+                ++solidTypes_[(*s)->GetEntityType()];
+                memory_.solids += this->SolidBytes(*s, false, memory_.facets, nFacets_);
+            }
+
+            PointerSet visAttributes, voxels;
+            G4LogicalVolumeStore* logicals = G4LogicalVolumeStore::GetInstance();
+            nLogical_ = logicals->size();
+            for(G4LogicalVolumeStore::const_iterator lv = logicals->begin(); lv != logicals->end(); ++lv) {
+                memory_.volumes += sizeof(G4LogicalVolume) + (*lv)->GetNoDaughters()*sizeof(G4VPhysicalVolume*);
+                if((*lv)->GetVisAttributes()) visAttributes.insert((*lv)->GetVisAttributes());
+                if((*lv)->GetVoxelHeader()) {
+                    isVoxelized_ = true;
+                    memory_.voxels += this->VoxelBytes((*lv)->GetVoxelHeader(), voxels);
+                }
+            }
+            memory_.visAttributes = visAttributes.size()*sizeof(G4VisAttributes);
+
+            PointerSet rotations;
+            G4PhysicalVolumeStore* physicals = G4PhysicalVolumeStore::GetInstance();
+            nPhysical_ = physicals->size();
+            for(G4PhysicalVolumeStore::const_iterator pv = physicals->begin(); pv != physicals->end(); ++pv) {
+                memory_.volumes += PhysicalVolumeBytes(*pv);
+                if((*pv)->GetRotation()) rotations.insert((*pv)->GetRotation());
+            }
+            memory_.volumes += rotations.size()*sizeof(G4RotationMatrix);
+
+            nMaterials_ = G4Material::GetMaterialTable()->size();
+            memory_.materials = this->MaterialBytes();
+
+            //----- The tree below world, children before parents in order
+            std::vector<const G4LogicalVolume*> order;
+            const G4LogicalVolume* top = world->GetLogicalVolume();
+            nTouchables_ = 1 + this->CountBelow(top, order);
+            maxDepth_ = static_cast<G4int>(depth_[top]);
+
+            //----- Touchables of each volume, parents first
+            CountMap instances;
+            instances[top] = 1;
+            for(std::vector<const G4LogicalVolume*>::reverse_iterator lv = order.rbegin(); lv != order.rend(); ++lv) {
+                uint64_t n = instances[*lv];
+                for(G4int i = 0; i < (*lv)->GetNoDaughters(); ++i) {
+                    G4VPhysicalVolume* pv = (*lv)->GetDaughter(i);
+                    instances[pv->GetLogicalVolume()] += n*std::max(pv->GetMultiplicity(), 1);
+                }
+            }
+
+            for(std::vector<const G4LogicalVolume*>::const_iterator lv = order.begin(); lv != order.end(); ++lv) {
+                size_t facetBytes(0), nFacets(0);
+                PointerSet ownVoxels;
+                VolumeEntry e;
+                e.lv = *lv;
+                e.daughters = (*lv)->GetNoDaughters();
+                e.touchables = instances[*lv];
+                e.bytes = this->SolidBytes((*lv)->GetSolid(), true, facetBytes, nFacets);
+                e.bytes += facetBytes + sizeof(G4LogicalVolume) + e.daughters*sizeof(G4VPhysicalVolume*);
+                if((*lv)->GetVoxelHeader()) e.bytes += this->VoxelBytes((*lv)->GetVoxelHeader(), ownVoxels);
+                volumes_.push_back(e);
+
+                if(e.daughters > maxDaughters_) {
+                    maxDaughters_ = e.daughters;
+                    maxDaughtersVolume_ = (*lv)->GetName();
+                }
+            }
+            std::stable_sort(volumes_.begin(), volumes_.end(), &GeometryStats::IsHeavier);
+
+            below_.clear();
+            depth_.clear();
+        }
+
+
+        uint64_t GeometryStats::CountBelow(const G4LogicalVolume* lv, std::vector<const G4LogicalVolume*>& order)
+        {
+            //----- Touchables below one placement of lv, memoized so shared
+            // subtrees are walked once
+            CountMap::const_iterator known = below_.find(lv);
+            if(known != below_.end()) return known->second;
+
+            uint64_t n(0), depth(0);
+            for(G4int i = 0; i < lv->GetNoDaughters(); ++i) {
+                G4VPhysicalVolume* pv = lv->GetDaughter(i);
+                const G4LogicalVolume* daughter = pv->GetLogicalVolume();
+                n += std::max(pv->GetMultiplicity(), 1)*(1 + this->CountBelow(daughter, order));
+                depth = std::max(depth, 1 + depth_[daughter]);
+            }
+            below_[lv] = n;
+            depth_[lv] = depth;
+            order.push_back(lv);
+            return n;
+        }
+
+
+        size_t GeometryStats::SolidBytes(const G4VSolid* solid, G4bool withConstituents, size_t& facetBytes,
+                size_t& nFacets) const
+        {
+            if(!solid) return 0;
+
+            if(const G4TessellatedSolid* t = dynamic_cast<const G4TessellatedSolid*>(solid)) {
+                for(G4int i = 0; i < t->GetNumberOfFacets(); ++i) {
+                    const G4VFacet* facet = t->GetFacet(i);
+                    facetBytes += sizeof(G4VFacet*)
+                        + (facet->GetNumberOfVertices() == 4 ? sizeof(G4QuadrangularFacet) : sizeof(G4TriangularFacet));
+                    ++nFacets;
+                }
+                return sizeof(G4TessellatedSolid);
+            }
+            if(const G4Polycone* p = dynamic_cast<const G4Polycone*>(solid)) {
+                return sizeof(G4Polycone) + p->GetNumRZCorner()*sizeof(G4PolyconeSide);
+            }
+            if(const G4Polyhedra* p = dynamic_cast<const G4Polyhedra*>(solid)) {
+                return sizeof(G4Polyhedra) + p->GetNumRZCorner()*sizeof(G4PolyhedraSide);
+            }
+            if(const G4BooleanSolid* b = dynamic_cast<const G4BooleanSolid*>(solid)) {
+                size_t bytes = sizeof(G4BooleanSolid);
+                if(withConstituents) {
+                    bytes += this->SolidBytes(b->GetConstituentSolid(0), true, facetBytes, nFacets);
+                    bytes += this->SolidBytes(b->GetConstituentSolid(1), true, facetBytes, nFacets);
+                }
+                return bytes;
+            }
+            if(const G4DisplacedSolid* d = dynamic_cast<const G4DisplacedSolid*>(solid)) {
+                size_t bytes = sizeof(G4DisplacedSolid);
+                if(withConstituents) bytes += this->SolidBytes(d->GetConstituentMovedSolid(), true, facetBytes, nFacets);
+                return bytes;
+            }
+            if(const G4ReflectedSolid* r = dynamic_cast<const G4ReflectedSolid*>(solid)) {
+                size_t bytes = sizeof(G4ReflectedSolid);
+                if(withConstituents) bytes += this->SolidBytes(r->GetConstituentMovedSolid(), true, facetBytes, nFacets);
+                return bytes;
+            }
+            return SizeOfType(solid->GetEntityType());
+        }
+
+
+        size_t GeometryStats::VoxelBytes(const G4SmartVoxelHeader* header, PointerSet& seen) const
+        {
+            //----- Consecutive equivalent slices share a proxy, so count
+            // each proxy, node and sub-header once
+            if(!seen.insert(header).second) return 0;
+
+            size_t nSlices = header->GetNoSlices();
+            size_t bytes = sizeof(G4SmartVoxelHeader) + nSlices*sizeof(G4SmartVoxelProxy*);
+            for(size_t i = 0; i < nSlices; ++i) {
+                const G4SmartVoxelProxy* proxy = header->GetSlice(static_cast<G4int>(i));
+                if(!seen.insert(proxy).second) continue;
+                bytes += sizeof(G4SmartVoxelProxy);
+
+                if(proxy->IsHeader()) {
+                    bytes += this->VoxelBytes(proxy->GetHeader(), seen);
+                }
+                else if(seen.insert(proxy->GetNode()).second) {
+                    bytes += sizeof(G4SmartVoxelNode) + proxy->GetNode()->GetNoContained()*sizeof(G4int);
+                }
+            }
+            return bytes;
+        }
+
+
+        size_t GeometryStats::MaterialBytes() const
+        {
+            //----- Each material also owns its ionisation parameters and
+            // Sandia table, and per element fractions and densities
+            size_t bytes(0);
+            const G4MaterialTable* materials = G4Material::GetMaterialTable();
+            for(G4MaterialTable::const_iterator m = materials->begin(); m != materials->end(); ++m) {
+                bytes += sizeof(G4Material) + sizeof(G4IonisParamMat) + sizeof(G4SandiaTable)
+                    + (*m)->GetNumberOfElements()*(sizeof(G4Element*) + 2*sizeof(G4double));
+            }
+
+            const std::vector<G4Element*>* elements = G4Element::GetElementTable();
+            for(std::vector<G4Element*>::const_iterator e = elements->begin(); e != elements->end(); ++e) {
+                bytes += sizeof(G4Element) + (*e)->GetNumberOfIsotopes()*(sizeof(G4Isotope*) + sizeof(G4double));
+            }
+            bytes += G4Isotope::GetIsotopeTable()->size()*sizeof(G4Isotope);
+            return bytes;
+        }
+
+
+        bool GeometryStats::IsHeavier(const VolumeEntry& a, const VolumeEntry& b)
+        {
+            return a.bytes > b.bytes;
+        }
+
+
+        void GeometryStats::Print(std::ostream& os, size_t nTop) const
+        {
+            //----- Names come from the gdml file, so columns widen for long
+            // ones. Formatted apart from os to leave its flags alone.
+            std::ostringstream table;
+            table<<std::fixed<<std::setprecision(1);
+            table<<"Geometry statistics for "<<worldName_<<"\n";
+            Row(table, 2, 24, "solids", nSolids_)<<"\n";
+            for(std::map<std::string, size_t>::const_iterator t = solidTypes_.begin(); t != solidTypes_.end(); ++t) {
+                Row(table, 4, 22, t->first, t->second)<<"\n";
+            }
+            Row(table, 2, 24, "logical volumes", nLogical_)<<"\n";
+            Row(table, 2, 24, "physical volumes", nPhysical_)<<"\n";
+            Row(table, 2, 24, "touchables", nTouchables_)<<"\n";
+            Row(table, 2, 24, "maximum depth", maxDepth_)<<"\n";
+            Row(table, 2, 24, "maximum daughters", maxDaughters_)<<"  ("<<maxDaughtersVolume_<<")\n";
+            Row(table, 2, 24, "materials", nMaterials_)<<"\n";
+            Row(table, 2, 24, "facets", nFacets_)<<"\n";
+
+            table<<"Estimated memory [kB]\n";
+            const char* names[] = {"solids", "facets", "voxels", "volumes", "materials", "vis attributes", "total"};
+            size_t bytes[] = {memory_.solids, memory_.facets, memory_.voxels, memory_.volumes, memory_.materials,
+                memory_.visAttributes, memory_.Total()};
+            for(size_t i = 0; i < 7; ++i) {
+                Row(table, 2, 24, names[i], Kilobytes(bytes[i]))<<(i == 2 && !isVoxelized_ ? "  (geometry not closed)" : "")<<"\n";
+            }
+
+            if(nTop > 0 && !volumes_.empty()) {
+                table<<"Heaviest logical volumes\n";
+                table<<"  "<<std::left<<std::setw(40)<<"volume"<<" "<<std::right<<std::setw(12)<<"kB"
+                     <<" "<<std::left<<std::setw(20)<<"solid"<<" "<<std::right<<std::setw(9)<<"daughters"
+                     <<" "<<std::setw(12)<<"touchables"<<"\n";
+                for(size_t i = 0; i < std::min(nTop, volumes_.size()); ++i) {
+                    const VolumeEntry& e = volumes_[i];
+                    table<<"  "<<std::left<<std::setw(40)<<e.lv->GetName()<<" "<<std::right<<std::setw(12)<<Kilobytes(e.bytes)
+                         <<" "<<std::left<<std::setw(20)<<e.lv->GetSolid()->GetEntityType()
+                         <<" "<<std::right<<std::setw(9)<<e.daughters<<" "<<std::setw(12)<<e.touchables<<"\n";
+                }
+            }
+            os<<table.str()<<std::flush;
+        }
+
+
+        void GeometryStats::WriteJSON(std::ostream& os, size_t nTop) const
+        {
+            using latte::json::Quote;
+
+            os<<"{\"world\": "<<Quote(worldName_)
+              <<", \"solids\": "<<nSolids_
+              <<", \"solid_types\": {";
+            for(std::map<std::string, size_t>::const_iterator t = solidTypes_.begin(); t != solidTypes_.end(); ++t) {
+                os<<(t == solidTypes_.begin() ? "" : ", ")<<Quote(t->first)<<": "<<t->second;
+            }
+            os<<"}, \"logical_volumes\": "<<nLogical_
+              <<", \"physical_volumes\": "<<nPhysical_
+              <<", \"touchables\": "<<nTouchables_
+              <<", \"max_depth\": "<<maxDepth_
+              <<", \"max_daughters\": "<<maxDaughters_
+              <<", \"max_daughters_volume\": "<<Quote(maxDaughtersVolume_)
+              <<", \"materials\": "<<nMaterials_
+              <<", \"facets\": "<<nFacets_
+              <<", \"voxelized\": "<<(isVoxelized_ ? "true" : "false")
+              <<", \"memory_bytes\": {\"solids\": "<<memory_.solids
+              <<", \"facets\": "<<memory_.facets
+              <<", \"voxels\": "<<memory_.voxels
+              <<", \"volumes\": "<<memory_.volumes
+              <<", \"materials\": "<<memory_.materials
+              <<", \"vis_attributes\": "<<memory_.visAttributes
+              <<", \"total\": "<<memory_.Total()<<"}"
+              <<", \"heaviest\": [";
+            for(size_t i = 0; i < std::min(nTop, volumes_.size()); ++i) {
+                const VolumeEntry& e = volumes_[i];
+                os<<(i ? ", " : "")<<"{\"volume\": "<<Quote(e.lv->GetName())<<", \"bytes\": "<<e.bytes
+                  <<", \"solid\": "<<Quote(e.lv->GetSolid()->GetEntityType())<<", \"daughters\": "<<e.daughters
+                  <<", \"touchables\": "<<e.touchables<<"}";
+            }
+            os<<"]}";
+        }
+
+    } // namespace geometry
+} // namespace latte
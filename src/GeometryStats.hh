@@ -0,0 +1,118 @@
+#ifndef GEOMETRYSTATS_HH
+#define GEOMETRYSTATS_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Size and shape of a geometry: solids by type, volumes,
+//              placements, touchables, depth and fan out, and an estimate of
+//              the memory held by each Geant4 store, with the logical volumes
+//              that hold the most.
+//
+//              Memory is estimated from object sizes and counts (facets,
+//              polycone sides, voxel slices and nodes, ...), not measured,
+//              so it is a lower bound that is comparable between revisions.
+//              Voxels only exist once the geometry has been closed.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <stdint.h>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+class G4SmartVoxelHeader;
+
+namespace latte {
+    namespace geometry {
+
+        class GeometryStats
+        {
+            public:
+                //----- Estimated bytes per store
+                struct Memory
+                {
+                    Memory() : solids(0), facets(0), voxels(0), volumes(0), materials(0), visAttributes(0) {;}
+
+                    size_t Total() const {return solids + facets + voxels + volumes + materials + visAttributes;}
+
+                    size_t solids;
+                    size_t facets;
+                    size_t voxels;
+                    size_t volumes;
+                    size_t materials;
+                    size_t visAttributes;
+                };
+
+                //----- One logical volume and what it holds itself: its
+                // solid (with constituents and facets), voxels and daughter
+                // list. Shared solids are counted for every volume.
+                struct VolumeEntry
+                {
+                    const G4LogicalVolume* lv;
+                    size_t                 bytes;
+                    G4int                  daughters;
+                    uint64_t               touchables;
+                };
+
+            public:
+                GeometryStats();
+                ~GeometryStats();
+
+                //----- Gather everything for the tree below world, and the
+                // stores it was built from
+                void Collect(G4VPhysicalVolume* world);
+
+                //----- Human readable summary, with the nTop heaviest volumes
+                void Print(std::ostream& os, size_t nTop) const;
+
+                //----- The same as a JSON object
+                void WriteJSON(std::ostream& os, size_t nTop) const;
+
+            private:
+                typedef boost::unordered_map<const G4LogicalVolume*, uint64_t> CountMap;
+                typedef boost::unordered_set<const void*> PointerSet;
+
+            private:
+                void Clear();
+                uint64_t CountBelow(const G4LogicalVolume* lv, std::vector<const G4LogicalVolume*>& order);
+                size_t SolidBytes(const G4VSolid* solid, G4bool withConstituents, size_t& facetBytes, size_t& nFacets) const;
+                size_t VoxelBytes(const G4SmartVoxelHeader* header, PointerSet& seen) const;
+                size_t MaterialBytes() const;
+
+                static bool IsHeavier(const VolumeEntry& a, const VolumeEntry& b);
+
+            private:
+                std::string                   worldName_;
+                std::map<std::string, size_t> solidTypes_;
+                size_t                        nSolids_;
+                size_t                        nLogical_;
+                size_t                        nPhysical_;
+                size_t                        nMaterials_;
+                size_t                        nFacets_;
+                uint64_t                      nTouchables_;
+                G4int                         maxDepth_;
+                G4int                         maxDaughters_;
+                std::string                   maxDaughtersVolume_;
+                G4bool                        isVoxelized_;
+                Memory                        memory_;
+                std::vector<VolumeEntry>      volumes_;
+
+                //----- Working state of Collect
+                CountMap                      below_;
+                CountMap                      depth_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // GEOMETRYSTATS_HH
@@ -0,0 +1,51 @@
+#include "GeometryStatsMessenger.hh"
+
+#include "GeometryStats.hh"
+#include "VolumeIndex.hh"
+
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4ios.hh"
+
+namespace latte {
+    namespace geometry {
+
+        GeometryStatsMessenger::GeometryStatsMessenger(const VolumeIndex* index) : G4UImessenger(), pIndex_(index),
+        pStatsCmd_(0)
+        {
+            //----- Default Constructor
+            pStatsCmd_ = new G4UIcmdWithAnInteger("/gdmlview/stats",this);
+            pStatsCmd_->SetGuidance("print counts of solids by type, volumes, placements and touchables,");
+            pStatsCmd_->SetGuidance("the maximum depth and daughters, and estimated memory per store");
+            pStatsCmd_->SetGuidance("with the given number of logical volumes holding the most memory");
+            pStatsCmd_->SetGuidance("voxel memory is only known once the geometry is closed, e.g. after beamOn");
+            pStatsCmd_->SetParameterName("top", true);
+            pStatsCmd_->SetDefaultValue(10);
+            pStatsCmd_->SetRange("top >= 0");
+            pStatsCmd_->AvailableForStates(G4State_Idle);
+        }
+
+        GeometryStatsMessenger::~GeometryStatsMessenger()
+        {
+            //----- Destructor
+            delete pStatsCmd_;
+        }
+
+
+        void GeometryStatsMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pStatsCmd_) {
+                VolumeIndex::Path world;
+                if(!pIndex_->Resolve("/", world)) {
+                    G4cerr<<"gdmlview: no geometry loaded"<<G4endl;
+                    return;
+                }
+
+                GeometryStats stats;
+                stats.Collect(world.back().first);
+                stats.Print(G4cout, pStatsCmd_->GetNewIntValue(args));
+            }
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,39 @@
+#ifndef GEOMETRYSTATSMESSENGER_HH
+#define GEOMETRYSTATSMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for GeometryStats
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+
+namespace latte {
+    namespace geometry {
+
+        class VolumeIndex;
+
+        class GeometryStatsMessenger : public G4UImessenger
+        {
+            public:
+                GeometryStatsMessenger(const VolumeIndex* index);
+                virtual ~GeometryStatsMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                const VolumeIndex*    pIndex_;
+
+                G4UIcmdWithAnInteger* pStatsCmd_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // GEOMETRYSTATSMESSENGER_HH
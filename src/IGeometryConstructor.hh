@@ -22,6 +22,10 @@ namespace latte {
                 virtual ~IGeometryConstructor() {;}
 
                 virtual G4VPhysicalVolume* Construct()=0;
+
+                //----- Start constructing in the background, if supported.
+                // The next Construct() then collects the result.
+                virtual void Prefetch() {;}
         };
 
     } // namespace geometry
@@ -0,0 +1,46 @@
+#ifndef IUSERACTIONOBSERVER_HH
+#define IUSERACTIONOBSERVER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: PABC for objects wanting run/event/track/step callbacks.
+//              Geant4 allows only one user action of each type, so
+//              observers are multiplexed by UserActionDispatcher.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+class G4Run;
+class G4Event;
+class G4Track;
+class G4Step;
+
+namespace latte {
+    namespace action {
+
+        class IUserActionObserver {
+            public:
+                IUserActionObserver() {;}
+                virtual ~IUserActionObserver() {;}
+
+                //----- Run level
+                virtual void BeginOfRun(const G4Run*) {;}
+                virtual void EndOfRun(const G4Run*) {;}
+
+                //----- Event level
+                virtual void BeginOfEvent(const G4Event*) {;}
+                virtual void EndOfEvent(const G4Event*) {;}
+
+                //----- Track level
+                virtual void PreTrack(const G4Track*) {;}
+                virtual void PostTrack(const G4Track*) {;}
+
+                //----- Step level
+                virtual void Step(const G4Step*) {;}
+        };
+
+    } // namespace action
+} // namespace latte
+#endif // IUSERACTIONOBSERVER_HH
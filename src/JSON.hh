@@ -0,0 +1,46 @@
+#ifndef JSON_HH
+#define JSON_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Helpers for the JSON reports written by gdmlview.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <cstdio>
+#include <string>
+
+namespace latte {
+    namespace json {
+
+        //----- s as a JSON string literal, quotes included
+        inline std::string Quote(const std::string& s)
+        {
+            std::string out("\"");
+            for(std::string::const_iterator c = s.begin(); c != s.end(); ++c) {
+                switch(*c) {
+                    case '"':  out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if(static_cast<unsigned char>(*c) < 0x20) {
+                            char escaped[8];
+                            std::sprintf(escaped, "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(*c)));
+                            out += escaped;
+                        }
+                        else {
+                            out += *c;
+                        }
+                }
+            }
+            return out + "\"";
+        }
+
+    } // namespace json
+} // namespace latte
+#endif // JSON_HH
@@ -0,0 +1,438 @@
+#include "MassCalculator.hh"
+
+#include "Xoshiro256Engine.hh"
+#include "ProfilingNavigator.hh"
+#include "PointLocator.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+    //----- Points per sampling block, and in the first pass that
+    // estimates each solid's fill fraction
+    const uint64_t kBlockPoints = 1 << 16;
+    const uint64_t kPilotPoints = 1 << 14;
+    const uint64_t kMaxPoints = 1000000000ULL;
+    const uint64_t kSeed = 0x6d617373ULL;
+
+    struct Sample
+    {
+        G4VSolid*     solid;
+        G4ThreeVector lo;
+        G4ThreeVector extent;
+        G4bool        isParallelSafe;
+        uint64_t      points;
+        uint64_t      hits;
+        uint64_t      nBlocks;
+    };
+
+    struct Block
+    {
+        size_t   sample;
+        uint64_t points;
+        uint64_t seed;
+        uint64_t hits;
+    };
+
+    //----- Workers take blocks in order until none are left. Blocks of
+    // solids that cache state in Inside() run one at a time, all behind
+    // one lock since such solids may be shared between booleans.
+    class BlockQueue
+    {
+        public:
+            BlockQueue(std::vector<Block>& blocks, const std::vector<Sample>& samples) : blocks_(blocks),
+            samples_(samples), mutex_(), serial_(), next_(0)
+            {;}
+
+            void Run()
+            {
+                while(true) {
+                    size_t i;
+                    {
+                        boost::mutex::scoped_lock lock(mutex_);
+                        if(next_ == blocks_.size()) return;
+                        i = next_++;
+                    }
+
+                    Block& b = blocks_[i];
+                    const Sample& s = samples_[b.sample];
+                    boost::unique_lock<boost::mutex> serial(serial_, boost::defer_lock);
+                    if(!s.isParallelSafe) serial.lock();
+
+                    latte::random::Xoshiro256Engine engine(b.seed);
+                    uint64_t hits = 0;
+                    for(uint64_t n = 0; n < b.points; ++n) {
+                        G4ThreeVector p(s.lo.x() + engine.flat()*s.extent.x(),
+                                        s.lo.y() + engine.flat()*s.extent.y(),
+                                        s.lo.z() + engine.flat()*s.extent.z());
+                        if(s.solid->Inside(p) != kOutside) ++hits;
+                    }
+                    b.hits = hits;
+                }
+            }
+
+        private:
+            std::vector<Block>&        blocks_;
+            const std::vector<Sample>& samples_;
+            boost::mutex               mutex_;
+            boost::mutex               serial_;
+            size_t                     next_;
+    };
+
+    //----- Blocks taking sample i up to total points
+    void AddBlocks(size_t i, Sample& s, uint64_t total, std::vector<Block>& blocks)
+    {
+        for(uint64_t n = s.points; n < total; n += kBlockPoints) {
+            Block b = {i, std::min(kBlockPoints, total - n), latte::random::DeriveSeed(kSeed, i, ++s.nBlocks), 0};
+            blocks.push_back(b);
+        }
+    }
+
+    void RunBlocks(std::vector<Block>& blocks, std::vector<Sample>& samples, G4int nThreads)
+    {
+        BlockQueue queue(blocks, samples);
+        boost::thread_group workers;
+        for(G4int t = 0; t < nThreads; ++t) {
+            workers.create_thread(boost::bind(&BlockQueue::Run, &queue));
+        }
+        workers.join_all();
+
+        for(std::vector<Block>::const_iterator b = blocks.begin(); b != blocks.end(); ++b) {
+            samples[b->sample].points += b->points;
+            samples[b->sample].hits += b->hits;
+        }
+    }
+
+    //----- One row of the mass table. Names come from the gdml file, so
+    // the first column widens for long ones.
+    std::string Row(const std::string& name, const std::string& copies, G4double volume, G4double mass,
+            G4double percent)
+    {
+        std::ostringstream row;
+        row<<std::left<<std::setw(48)<<name<<std::right<<" "<<std::setw(8)<<copies
+           <<std::setprecision(6)<<" "<<std::setw(14)<<volume<<" "<<std::setw(14)<<mass
+           <<std::fixed<<std::setprecision(2)<<" "<<std::setw(7)<<percent;
+        return row.str();
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        MassCalculator::MassCalculator() : precision_(1.0e-3), nThreads_(0), volumes_(), masses_(), nOverlapWarnings_(0)
+        {;}
+
+
+        MassCalculator::~MassCalculator()
+        {;}
+
+
+        void MassCalculator::SetPrecision(G4double relative)
+        {
+            if(relative <= 0.0) return;
+            if(relative < precision_) masses_.clear();
+            precision_ = relative;
+        }
+
+
+        void MassCalculator::Clear()
+        {
+            volumes_.clear();
+            masses_.clear();
+            nOverlapWarnings_ = 0;
+        }
+
+
+        G4double MassCalculator::GetMass(G4LogicalVolume* lv)
+        {
+            this->Prepare(lv);
+            return this->ComputeMass(lv);
+        }
+
+
+        G4double MassCalculator::GetCubicVolume(G4VSolid* solid)
+        {
+            SolidMap::const_iterator entry = volumes_.find(solid);
+            if(entry != volumes_.end() && entry->second.precision <= precision_) return entry->second.volume;
+
+            if(HasClosedFormVolume(solid)) {
+                SolidEntry& e = volumes_[solid];
+                e.volume = solid->GetCubicVolume();
+                e.precision = 0.0;
+                return e.volume;
+            }
+
+            this->Estimate(std::vector<G4VSolid*>(1, solid));
+            return volumes_[solid].volume;
+        }
+
+
+        void MassCalculator::Prepare(G4LogicalVolume* top)
+        {
+            //----- Gather every solid below top still needing a sampled
+            // volume, so they can all be estimated in one parallel pass
+            std::vector<G4VSolid*> toSample;
+            boost::unordered_set<const G4VSolid*> queued;
+            boost::unordered_set<const G4LogicalVolume*> visited;
+            std::vector<G4LogicalVolume*> stack(1, top);
+
+            while(!stack.empty()) {
+                G4LogicalVolume* lv = stack.back();
+                stack.pop_back();
+                if(!visited.insert(lv).second || masses_.count(lv)) continue;
+
+                G4VSolid* solid = lv->GetSolid();
+                SolidMap::const_iterator entry = volumes_.find(solid);
+                bool cached = entry != volumes_.end() && entry->second.precision <= precision_;
+                if(!cached && !HasClosedFormVolume(solid) && queued.insert(solid).second) {
+                    toSample.push_back(solid);
+                }
+
+                for(G4int i = 0; i < lv->GetNoDaughters(); ++i) {
+                    stack.push_back(lv->GetDaughter(i)->GetLogicalVolume());
+                }
+            }
+
+            if(!toSample.empty()) this->Estimate(toSample);
+        }
+
+
+        void MassCalculator::Estimate(const std::vector<G4VSolid*>& solids)
+        {
+            std::vector<Sample> samples(solids.size());
+            std::vector<Block> blocks;
+            for(size_t i = 0; i < solids.size(); ++i) {
+                G4VisExtent ext = solids[i]->GetExtent();
+                samples[i].solid = solids[i];
+                samples[i].lo = G4ThreeVector(ext.GetXmin(), ext.GetYmin(), ext.GetZmin());
+                samples[i].extent = G4ThreeVector(ext.GetXmax() - ext.GetXmin(), ext.GetYmax() - ext.GetYmin(),
+                        ext.GetZmax() - ext.GetZmin());
+                samples[i].isParallelSafe = PointLocator::IsParallelSafe(solids[i]);
+                samples[i].points = 0;
+                samples[i].hits = 0;
+                samples[i].nBlocks = 0;
+
+                Block b = {i, kPilotPoints, latte::random::DeriveSeed(kSeed, i, 0), 0};
+                blocks.push_back(b);
+            }
+
+            G4int nThreads = this->NumberOfThreads();
+            RunBlocks(blocks, samples, nThreads);
+
+            //----- Thin shells and small solids in large extents may have
+            // no hits yet. Sample those again with 16 times the points until
+            // they do, as no precision can be sized from zero hits.
+            while(true) {
+                blocks.clear();
+                for(size_t i = 0; i < samples.size(); ++i) {
+                    Sample& s = samples[i];
+                    if(s.hits == 0 && s.points < kMaxPoints) AddBlocks(i, s, std::min(16*s.points, kMaxPoints), blocks);
+                }
+                if(blocks.empty()) break;
+                RunBlocks(blocks, samples, nThreads);
+            }
+
+            //----- Relative error of a fill fraction f from N points is
+            // sqrt((1-f)/(f N)), so size the last pass from the hits so far
+            blocks.clear();
+            for(size_t i = 0; i < samples.size(); ++i) {
+                Sample& s = samples[i];
+                if(s.hits == 0 || s.hits == s.points) continue;
+
+                G4double f = static_cast<G4double>(s.hits)/s.points;
+                G4double needed = (1.0 - f)/(f*precision_*precision_);
+                AddBlocks(i, s, static_cast<uint64_t>(std::min(needed, static_cast<G4double>(kMaxPoints))), blocks);
+            }
+            RunBlocks(blocks, samples, nThreads);
+
+            for(std::vector<Sample>::const_iterator s = samples.begin(); s != samples.end(); ++s) {
+                SolidEntry& e = volumes_[s->solid];
+                e.precision = precision_;
+                if(s->hits) {
+                    e.volume = s->extent.x()*s->extent.y()*s->extent.z()*s->hits/s->points;
+                    continue;
+                }
+
+                //----- Still nothing inside, so leave it to Geant4
+                G4cerr<<"gdmlview: no sampled points inside solid "<<s->solid->GetName()
+                      <<", using Geant4's volume estimate"<<G4endl;
+                e.volume = s->solid->GetCubicVolume();
+            }
+        }
+
+
+        G4double MassCalculator::ComputeMass(G4LogicalVolume* lv)
+        {
+            MassMap::const_iterator memo = masses_.find(lv);
+            if(memo != masses_.end()) return memo->second;
+
+            G4double daughtersVolume(0.0), daughtersMass(0.0);
+            for(G4int i = 0; i < lv->GetNoDaughters(); ++i) {
+                PlacementTotals t = this->GetPlacementTotals(lv->GetDaughter(i));
+                daughtersVolume += t.volume;
+                daughtersMass += t.mass;
+            }
+
+            G4double own = this->GetCubicVolume(lv->GetSolid()) - daughtersVolume;
+            if(own < 0.0) {
+                if(nOverlapWarnings_++ < 10) {
+                    G4cerr<<"gdmlview: daughters of "<<lv->GetName()<<" fill more than its volume, check for overlaps"<<G4endl;
+                }
+                own = 0.0;
+            }
+
+            const G4Material* material = lv->GetMaterial();
+            G4double mass = (material ? material->GetDensity()*own : 0.0) + daughtersMass;
+            masses_[lv] = mass;
+            return mass;
+        }
+
+
+        MassCalculator::PlacementTotals MassCalculator::GetPlacementTotals(G4VPhysicalVolume* pv)
+        {
+            PlacementTotals t;
+            G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+            if(!pv->IsParameterised()) {
+                t.copies = pv->IsReplicated() ? pv->GetMultiplicity() : 1;
+                t.volume = t.copies*this->GetCubicVolume(lv->GetSolid());
+                t.mass = t.copies*this->ComputeMass(lv);
+                return t;
+            }
+
+            //----- Each copy may have its own solid dimensions and material,
+            // so these are summed serially and not cached
+            G4double innerVolume(0.0), innerMass(0.0);
+            for(G4int i = 0; i < lv->GetNoDaughters(); ++i) {
+                PlacementTotals inner = this->GetPlacementTotals(lv->GetDaughter(i));
+                innerVolume += inner.volume;
+                innerMass += inner.mass;
+            }
+
+            G4VPVParameterisation* param = pv->GetParameterisation();
+            t.copies = pv->GetMultiplicity();
+            for(G4int copy = 0; copy < t.copies; ++copy) {
+                G4VSolid* solid = param->ComputeSolid(copy, pv);
+                solid->ComputeDimensions(param, copy, pv);
+                G4Material* material = param->ComputeMaterial(copy, pv, 0);
+                if(!material) material = lv->GetMaterial();
+
+                G4double volume = solid->GetCubicVolume();
+                t.volume += volume;
+                t.mass += (material ? material->GetDensity()*std::max(volume - innerVolume, 0.0) : 0.0) + innerMass;
+            }
+            return t;
+        }
+
+
+        void MassCalculator::Print(const VolumeIndex::Path& path, G4int depth, std::ostream& os)
+        {
+            G4LogicalVolume* lv = path.back().first->GetLogicalVolume();
+
+            uint64_t start = latte::profile::WallClockNs();
+            G4double total = this->GetMass(lv);
+            G4double seconds = (latte::profile::WallClockNs() - start)*1.0e-9;
+
+            os<<"Mass of "<<VolumeIndex::ToString(path)<<" (precision "<<precision_<<", "
+              <<this->NumberOfThreads()<<" threads, "<<seconds<<" s)"<<std::endl;
+            std::ostringstream header;
+            header<<std::left<<std::setw(48)<<"volume"<<std::right<<" "<<std::setw(8)<<"copies"<<" "<<std::setw(14)
+                  <<"volume [cm3]"<<" "<<std::setw(14)<<"mass [kg]"<<" "<<std::setw(7)<<"%";
+            os<<header.str()<<std::endl;
+            os<<Row(lv->GetName(), "1", this->GetCubicVolume(lv->GetSolid())/cm3, total/kg, 100.0)<<std::endl;
+
+            this->PrintLevel(lv, 1, depth, total, 1.0, os);
+        }
+
+
+        void MassCalculator::PrintLevel(G4LogicalVolume* lv, G4int level, G4int depth, G4double total, G4double scale,
+                std::ostream& os)
+        {
+            //----- Group daughters by name, keeping placement order. Rows
+            // are scaled by the number of copies of lv.
+            std::vector<std::pair<G4VPhysicalVolume*, PlacementTotals> > groups;
+            std::vector<G4int> placements;
+            G4double daughtersVolume(0.0), daughtersMass(0.0);
+            for(G4int i = 0; i < lv->GetNoDaughters(); ++i) {
+                G4VPhysicalVolume* pv = lv->GetDaughter(i);
+                PlacementTotals t = this->GetPlacementTotals(pv);
+                daughtersVolume += t.volume;
+                daughtersMass += t.mass;
+
+                size_t g = 0;
+                while(g < groups.size() && groups[g].first->GetName() != pv->GetName()) ++g;
+                if(g == groups.size()) {
+                    groups.push_back(std::make_pair(pv, PlacementTotals()));
+                    placements.push_back(0);
+                }
+                ++placements[g];
+                groups[g].second.copies += t.copies;
+                groups[g].second.volume += t.volume;
+                groups[g].second.mass += t.mass;
+            }
+
+            std::string indent(2*level, ' ');
+            const G4Material* material = lv->GetMaterial();
+            G4double ownVolume = std::max(this->GetCubicVolume(lv->GetSolid()) - daughtersVolume, 0.0);
+            G4double ownMass = std::max(this->ComputeMass(lv) - daughtersMass, 0.0);
+            std::string ownName = indent + "[" + (material ? material->GetName() : G4String("no material")) + "]";
+            os<<Row(ownName, "", scale*ownVolume/cm3, scale*ownMass/kg, total > 0.0 ? 100.0*scale*ownMass/total : 0.0)
+              <<std::endl;
+
+            for(size_t g = 0; g < groups.size(); ++g) {
+                const PlacementTotals& t = groups[g].second;
+                std::string name = indent + groups[g].first->GetName();
+                std::ostringstream copies;
+                copies<<std::fixed<<std::setprecision(0)<<scale*t.copies;
+                os<<Row(name, copies.str(), scale*t.volume/cm3, scale*t.mass/kg,
+                        total > 0.0 ? 100.0*scale*t.mass/total : 0.0)<<std::endl;
+
+                //----- Only descend where every copy has the same contents
+                if(level < depth && placements[g] == 1 && !groups[g].first->IsParameterised()) {
+                    this->PrintLevel(groups[g].first->GetLogicalVolume(), level + 1, depth, total, scale*t.copies, os);
+                }
+            }
+        }
+
+
+        G4int MassCalculator::NumberOfThreads() const
+        {
+            if(nThreads_ > 0) return nThreads_;
+            G4int nCores = static_cast<G4int>(boost::thread::hardware_concurrency());
+            return nCores > 0 ? nCores : 1;
+        }
+
+
+        G4bool MassCalculator::HasClosedFormVolume(const G4VSolid* solid)
+        {
+            //----- CSG solids whose GetCubicVolume is analytic. Everything
+            // else is sampled here rather than by Geant4's serial estimate.
+            static const char* analytic[] = {"G4Box", "G4Tubs", "G4Cons", "G4Orb", "G4Sphere", "G4Trd",
+                "G4Para", "G4Trap", "G4Torus", "G4Tet", 0};
+
+            G4String type = solid->GetEntityType();
+            for(const char** name = analytic; *name; ++name) {
+                if(type == *name) return true;
+            }
+            return false;
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,107 @@
+#ifndef MASSCALCULATOR_HH
+#define MASSCALCULATOR_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Cubic volume and mass of logical volume subtrees, in the
+//              same sense as G4LogicalVolume::GetMass, but memoized and
+//              parallel.
+//
+//              Solids with a closed form volume are asked directly. Others
+//              (booleans, tessellated, ...) are estimated by sampling Inside()
+//              over their extent, split into blocks over a pool of threads,
+//              with as many points as the requested relative precision
+//              needs. Solids that cache state in Inside(), e.g. polycones,
+//              are sampled one block at a time. Volumes are cached per solid
+//              and masses per logical volume, so shared volumes are computed
+//              once.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "VolumeIndex.hh"
+
+#include "globals.hh"
+
+#include <boost/unordered_map.hpp>
+#include <iosfwd>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+namespace latte {
+    namespace geometry {
+
+        class MassCalculator
+        {
+            public:
+                MassCalculator();
+                ~MassCalculator();
+
+                //----- Relative standard error of sampled volumes. Cached
+                // results are kept unless the precision is tightened.
+                void SetPrecision(G4double relative);
+                G4double GetPrecision() const {return precision_;}
+
+                //----- 0 uses every core
+                void SetThreads(G4int nThreads) {nThreads_ = nThreads > 0 ? nThreads : 0;}
+
+                //----- Forget all results, e.g. when the geometry changes
+                void Clear();
+
+                //----- Mass of lv and everything placed in it
+                G4double GetMass(G4LogicalVolume* lv);
+                G4double GetCubicVolume(G4VSolid* solid);
+
+                //----- Table of the volume at the end of path, broken down
+                // by daughter name to the given depth
+                void Print(const VolumeIndex::Path& path, G4int depth, std::ostream& os);
+
+            private:
+                struct SolidEntry
+                {
+                    SolidEntry() : volume(0.0), precision(0.0) {;}
+
+                    G4double volume;
+                    G4double precision;
+                };
+
+                //----- Summed over all copies of one placement
+                struct PlacementTotals
+                {
+                    PlacementTotals() : copies(0), volume(0.0), mass(0.0) {;}
+
+                    G4int    copies;
+                    G4double volume;
+                    G4double mass;
+                };
+
+                typedef boost::unordered_map<const G4VSolid*, SolidEntry> SolidMap;
+                typedef boost::unordered_map<const G4LogicalVolume*, G4double> MassMap;
+
+            private:
+                void Prepare(G4LogicalVolume* top);
+                void Estimate(const std::vector<G4VSolid*>& solids);
+                G4double ComputeMass(G4LogicalVolume* lv);
+                PlacementTotals GetPlacementTotals(G4VPhysicalVolume* pv);
+                void PrintLevel(G4LogicalVolume* lv, G4int level, G4int depth, G4double total, G4double scale,
+                        std::ostream& os);
+
+                G4int NumberOfThreads() const;
+                static G4bool HasClosedFormVolume(const G4VSolid* solid);
+
+            private:
+                G4double precision_;
+                G4int    nThreads_;
+                SolidMap volumes_;
+                MassMap  masses_;
+                G4int    nOverlapWarnings_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // MASSCALCULATOR_HH
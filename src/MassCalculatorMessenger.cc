@@ -0,0 +1,90 @@
+#include "MassCalculatorMessenger.hh"
+
+#include "MassCalculator.hh"
+#include "VolumeIndex.hh"
+
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4ios.hh"
+
+#include <sstream>
+
+namespace latte {
+    namespace geometry {
+
+        MassCalculatorMessenger::MassCalculatorMessenger(MassCalculator* messengedObject, const VolumeIndex* index) :
+        G4UImessenger(), pMessengedCalculator_(messengedObject), pIndex_(index), pMassCmd_(0), pPrecisionCmd_(0),
+        pThreadsCmd_(0), pClearCmd_(0)
+        {
+            //----- Default Constructor
+            pMassCmd_ = new G4UIcommand("/gdmlview/mass",this);
+            pMassCmd_->SetGuidance("print volume and mass of a volume, by name or path, and of its daughters");
+            pMassCmd_->SetGuidance("daughters are grouped by name and listed to the given depth");
+            pMassCmd_->SetGuidance("results are cached per logical volume until the geometry changes");
+            G4UIparameter* volume = new G4UIparameter("volume", 's', true);
+            volume->SetDefaultValue("/");
+            pMassCmd_->SetParameter(volume);
+            G4UIparameter* depth = new G4UIparameter("depth", 'i', true);
+            depth->SetDefaultValue(1);
+            depth->SetParameterRange("depth >= 0");
+            pMassCmd_->SetParameter(depth);
+            pMassCmd_->AvailableForStates(G4State_Idle);
+
+            pPrecisionCmd_ = new G4UIcmdWithADouble("/gdmlview/massPrecision",this);
+            pPrecisionCmd_->SetGuidance("relative standard error of sampled solid volumes (default 0.001)");
+            pPrecisionCmd_->SetParameterName("precision", false);
+            pPrecisionCmd_->SetRange("precision > 0 && precision < 1");
+            pPrecisionCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pThreadsCmd_ = new G4UIcmdWithAnInteger("/gdmlview/massThreads",this);
+            pThreadsCmd_->SetGuidance("number of sampling threads, 0 for one per core");
+            pThreadsCmd_->SetParameterName("n", false);
+            pThreadsCmd_->SetRange("n >= 0");
+            pThreadsCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pClearCmd_ = new G4UIcmdWithoutParameter("/gdmlview/massClear",this);
+            pClearCmd_->SetGuidance("forget cached volumes and masses");
+            pClearCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        MassCalculatorMessenger::~MassCalculatorMessenger()
+        {
+            //----- Destructor
+            delete pClearCmd_;
+            delete pThreadsCmd_;
+            delete pPrecisionCmd_;
+            delete pMassCmd_;
+        }
+
+
+        void MassCalculatorMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pMassCmd_) {
+                std::istringstream is(args);
+                std::string nameOrPath;
+                G4int depth(1);
+                is>>nameOrPath>>depth;
+
+                VolumeIndex::Path path;
+                if(!pIndex_->ResolveNameOrPath(nameOrPath, path)) {
+                    G4cerr<<"gdmlview: no volume \""<<nameOrPath<<"\""<<G4endl;
+                    return;
+                }
+                pMessengedCalculator_->Print(path, depth, G4cout);
+            }
+            else if ( cmd == pPrecisionCmd_) {
+                pMessengedCalculator_->SetPrecision(pPrecisionCmd_->GetNewDoubleValue(args));
+            }
+            else if ( cmd == pThreadsCmd_) {
+                pMessengedCalculator_->SetThreads(pThreadsCmd_->GetNewIntValue(args));
+            }
+            else if ( cmd == pClearCmd_) {
+                pMessengedCalculator_->Clear();
+            }
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,46 @@
+#ifndef MASSCALCULATORMESSENGER_HH
+#define MASSCALCULATORMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for MassCalculator
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+namespace latte {
+    namespace geometry {
+
+        class MassCalculator;
+        class VolumeIndex;
+
+        class MassCalculatorMessenger : public G4UImessenger
+        {
+            public:
+                MassCalculatorMessenger(MassCalculator* messengedObject, const VolumeIndex* index);
+                virtual ~MassCalculatorMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                MassCalculator*          pMessengedCalculator_;
+                const VolumeIndex*       pIndex_;
+
+                G4UIcommand*             pMassCmd_;
+                G4UIcmdWithADouble*      pPrecisionCmd_;
+                G4UIcmdWithAnInteger*    pThreadsCmd_;
+                G4UIcmdWithoutParameter* pClearCmd_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // MASSCALCULATORMESSENGER_HH
@@ -0,0 +1,183 @@
+#include "NavigationProfiler.hh"
+#include "ProfilingNavigator.hh"
+
+#include "G4Step.hh"
+#include "G4VTouchable.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+namespace {
+    using latte::profile::NavigationProfiler;
+
+    typedef std::pair<std::string, NavigationProfiler::Counters> NamedCounters;
+
+    bool MoreTime(const NamedCounters& a, const NamedCounters& b)
+    {
+        return a.second.ns > b.second.ns;
+    }
+
+    void PrintTable(std::ostream& os, const char* title, std::vector<NamedCounters>& rows, size_t topN, uint64_t totalNs)
+    {
+        std::sort(rows.begin(), rows.end(), MoreTime);
+
+        os<<title<<" (top "<<std::min(topN, rows.size())<<" of "<<rows.size()<<", by navigation time)"<<G4endl;
+        os<<std::setw(12)<<"steps"
+          <<std::setw(14)<<"ComputeStep"
+          <<std::setw(12)<<"locate"
+          <<std::setw(12)<<"time [ms]"
+          <<std::setw(12)<<"ns/step"
+          <<std::setw(8)<<"%"
+          <<"  name"<<G4endl;
+
+        for(size_t i = 0; i < rows.size() && i < topN; ++i) {
+            const NavigationProfiler::Counters& c = rows[i].second;
+            os<<std::setw(12)<<c.nSteps
+              <<std::setw(14)<<c.nComputeStep
+              <<std::setw(12)<<c.nLocate
+              <<std::setw(12)<<std::fixed<<std::setprecision(3)<<c.ns*1e-6
+              <<std::setw(12)<<std::setprecision(1)<<(c.nSteps ? double(c.ns)/c.nSteps : 0.)
+              <<std::setw(8)<<(totalNs ? 100.*c.ns/totalNs : 0.)
+              <<"  "<<rows[i].first<<G4endl;
+        }
+        os.unsetf(std::ios::floatfield);
+        os<<std::setprecision(6);
+    }
+}
+
+namespace latte {
+    namespace profile {
+
+        NavigationProfiler::NavigationProfiler(ProfilingNavigator* navigator, const G4String& foldedFile) : latte::action::IUserActionObserver(),
+        pNavigator_(navigator), foldedFile_(foldedFile), topN_(20),
+        paths_(), byPath_(), lvOfPath_()
+        {
+            //----- Constructor
+        }
+
+
+        NavigationProfiler::~NavigationProfiler()
+        {;}
+
+
+        void NavigationProfiler::Reset()
+        {
+            uint64_t ns;
+            uint32_t nCompute, nLocate;
+            pNavigator_->Drain(ns, nCompute, nLocate);
+
+            paths_.Clear();
+            byPath_.clear();
+            lvOfPath_.clear();
+        }
+
+
+        void NavigationProfiler::Step(const G4Step* aStep)
+        {
+            //----- Navigation done since the last step (this step's
+            // ComputeStep and the relocation at its end) is charged to the
+            // volume the step was taken in
+            const G4VTouchable* touchable = aStep->GetPreStepPoint()->GetTouchableHandle()();
+            uint32_t id = paths_.GetID(touchable);
+
+            if(id >= byPath_.size()) {
+                byPath_.resize(id + 1);
+                lvOfPath_.resize(id + 1, 0);
+                lvOfPath_[id] = touchable->GetVolume()->GetLogicalVolume();
+            }
+
+            uint64_t ns;
+            uint32_t nCompute, nLocate;
+            pNavigator_->Drain(ns, nCompute, nLocate);
+
+            Counters& c = byPath_[id];
+            ++c.nSteps;
+            c.ns += ns;
+            c.nComputeStep += nCompute;
+            c.nLocate += nLocate;
+        }
+
+
+        void NavigationProfiler::EndOfRun(const G4Run*)
+        {
+            this->Report(G4cout);
+            if(!foldedFile_.empty()) this->WriteFoldedStacks(foldedFile_);
+        }
+
+
+        void NavigationProfiler::Report(std::ostream& os) const
+        {
+            //----- Aggregate touchables into logical volumes and solid types
+            typedef std::map<const G4LogicalVolume*, Counters> LVMap;
+            typedef std::map<std::string, Counters> TypeMap;
+
+            LVMap byLV;
+            TypeMap byType;
+            Counters total;
+
+            for(size_t i = 0; i < byPath_.size(); ++i) {
+                byLV[lvOfPath_[i]] += byPath_[i];
+                byType[lvOfPath_[i]->GetSolid()->GetEntityType()] += byPath_[i];
+                total += byPath_[i];
+            }
+
+            std::vector<NamedCounters> lvRows;
+            for(LVMap::const_iterator iter = byLV.begin(); iter != byLV.end(); ++iter) {
+                const G4LogicalVolume* lv = iter->first;
+                lvRows.push_back(NamedCounters(lv->GetName() + " (" + lv->GetSolid()->GetEntityType() + ")", iter->second));
+            }
+
+            std::vector<NamedCounters> typeRows(byType.begin(), byType.end());
+
+            os<<"gdmlview navigation profile: "<<total.nSteps<<" steps, "
+              <<total.nComputeStep<<" ComputeStep calls, "
+              <<total.ns*1e-6<<" ms in navigation"<<G4endl;
+            PrintTable(os, "Logical volumes", lvRows, topN_, total.ns);
+            PrintTable(os, "Solid types", typeRows, typeRows.size(), total.ns);
+        }
+
+
+        G4bool NavigationProfiler::WriteFoldedStacks(const G4String& fileName) const
+        {
+            //----- One line per physical volume path, "World;Det;Cell ns",
+            // copy numbers merged
+            std::map<std::string, uint64_t> stacks;
+            const latte::geometry::TouchablePathIndex::PathList& paths = paths_.GetPaths();
+
+            for(size_t i = 0; i < paths.size(); ++i) {
+                std::string stack;
+                const std::string& p = paths[i];
+                size_t pos = 0;
+                while(pos < p.size()) {
+                    size_t begin = pos + 1;
+                    size_t colon = p.find(':', begin);
+                    size_t next = p.find('/', begin);
+                    if(next == std::string::npos) next = p.size();
+                    if(colon == std::string::npos || colon > next) colon = next;
+
+                    if(!stack.empty()) stack += ';';
+                    stack.append(p, begin, colon - begin);
+                    pos = next;
+                }
+                stacks[stack] += byPath_[i].ns;
+            }
+
+            std::ofstream out(fileName.c_str());
+            if(!out) {
+                G4cerr<<"gdmlview: cannot write folded stacks to \""<<fileName<<"\""<<G4endl;
+                return false;
+            }
+
+            for(std::map<std::string, uint64_t>::const_iterator iter = stacks.begin(); iter != stacks.end(); ++iter) {
+                if(iter->second) out<<iter->first<<" "<<iter->second<<"\n";
+            }
+            return true;
+        }
+
+    } // namespace profile
+} // namespace latte
@@ -0,0 +1,82 @@
+#ifndef NAVIGATIONPROFILER_HH
+#define NAVIGATIONPROFILER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User action observer attributing steps and navigation cost
+//              to touchables, logical volumes and solid types. At the end
+//              of each run it prints a sorted report and writes a folded
+//              stack file for flame graph tools.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "IUserActionObserver.hh"
+#include "TouchablePathIndex.hh"
+
+#include "globals.hh"
+
+#include <iosfwd>
+#include <vector>
+
+class G4LogicalVolume;
+
+namespace latte {
+    namespace profile {
+
+        class ProfilingNavigator;
+
+        class NavigationProfiler : public latte::action::IUserActionObserver
+        {
+            public:
+                struct Counters
+                {
+                    Counters() : nSteps(0), ns(0), nComputeStep(0), nLocate(0) {;}
+
+                    Counters& operator+=(const Counters& rhs)
+                    {
+                        nSteps += rhs.nSteps;
+                        ns += rhs.ns;
+                        nComputeStep += rhs.nComputeStep;
+                        nLocate += rhs.nLocate;
+                        return *this;
+                    }
+
+                    uint64_t nSteps;
+                    uint64_t ns;
+                    uint64_t nComputeStep;
+                    uint64_t nLocate;
+                };
+
+            public:
+                //----- Folded stacks are written to foldedFile at end of run
+                NavigationProfiler(ProfilingNavigator* navigator, const G4String& foldedFile);
+                virtual ~NavigationProfiler();
+
+                void SetReportLength(G4int n) {topN_ = n > 0 ? n : 1;}
+
+                void Reset();
+                void Report(std::ostream& os) const;
+                G4bool WriteFoldedStacks(const G4String& fileName) const;
+
+                //----- Observer interface
+                void EndOfRun(const G4Run*);
+                void Step(const G4Step* aStep);
+
+            private:
+                ProfilingNavigator*                 pNavigator_;
+                G4String                            foldedFile_;
+                G4int                               topN_;
+
+                //----- Indexed by touchable path ID. Counters live on the
+                // tracking thread only and are never locked.
+                latte::geometry::TouchablePathIndex paths_;
+                std::vector<Counters>               byPath_;
+                std::vector<const G4LogicalVolume*> lvOfPath_;
+        };
+
+    } // namespace profile
+} // namespace latte
+#endif // NAVIGATIONPROFILER_HH
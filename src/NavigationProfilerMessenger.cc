@@ -0,0 +1,69 @@
+#include "NavigationProfilerMessenger.hh"
+
+#include "NavigationProfiler.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4ios.hh"
+
+namespace latte {
+    namespace profile {
+
+        NavigationProfilerMessenger::NavigationProfilerMessenger(NavigationProfiler* messengedObject) : G4UImessenger(),
+        pMessengedProfiler_(messengedObject), pDirectory_(0), pPrintCmd_(0), pResetCmd_(0), pLengthCmd_(0), pFoldedCmd_(0)
+        {
+            //----- Default Constructor
+            pDirectory_ = new G4UIdirectory("/gdmlview/profile/");
+            pDirectory_->SetGuidance("Per volume navigation profiling (enabled with --profile)");
+
+            pPrintCmd_ = new G4UIcmdWithoutParameter("/gdmlview/profile/print",this);
+            pPrintCmd_->SetGuidance("print the navigation profile accumulated so far");
+            pPrintCmd_->AvailableForStates(G4State_Idle);
+
+            pResetCmd_ = new G4UIcmdWithoutParameter("/gdmlview/profile/reset",this);
+            pResetCmd_->SetGuidance("discard the accumulated navigation profile");
+            pResetCmd_->AvailableForStates(G4State_Idle);
+
+            pLengthCmd_ = new G4UIcmdWithAnInteger("/gdmlview/profile/length",this);
+            pLengthCmd_->SetGuidance("number of logical volumes listed in the report");
+            pLengthCmd_->SetParameterName("n", false);
+            pLengthCmd_->SetRange("n > 0");
+            pLengthCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pFoldedCmd_ = new G4UIcmdWithAString("/gdmlview/profile/writeFolded",this);
+            pFoldedCmd_->SetGuidance("write folded stacks (flame graph input) to the given file now");
+            pFoldedCmd_->SetParameterName("file", false);
+            pFoldedCmd_->AvailableForStates(G4State_Idle);
+        }
+
+        NavigationProfilerMessenger::~NavigationProfilerMessenger()
+        {
+            //----- Destructor
+            delete pFoldedCmd_;
+            delete pLengthCmd_;
+            delete pResetCmd_;
+            delete pPrintCmd_;
+            delete pDirectory_;
+        }
+
+
+        void NavigationProfilerMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pPrintCmd_) {
+                pMessengedProfiler_->Report(G4cout);
+            }
+            else if ( cmd == pResetCmd_) {
+                pMessengedProfiler_->Reset();
+            }
+            else if ( cmd == pLengthCmd_) {
+                pMessengedProfiler_->SetReportLength(pLengthCmd_->GetNewIntValue(args));
+            }
+            else if ( cmd == pFoldedCmd_) {
+                pMessengedProfiler_->WriteFoldedStacks(args);
+            }
+        }
+
+    } // namespace profile
+} // namespace latte
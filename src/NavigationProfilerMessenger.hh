@@ -0,0 +1,46 @@
+#ifndef NAVIGATIONPROFILERMESSENGER_HH
+#define NAVIGATIONPROFILERMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for NavigationProfiler
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+namespace latte {
+    namespace profile {
+
+        class NavigationProfiler;
+
+        class NavigationProfilerMessenger : public G4UImessenger
+        {
+            public:
+                NavigationProfilerMessenger(NavigationProfiler* messengedObject);
+                virtual ~NavigationProfilerMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                NavigationProfiler*      pMessengedProfiler_;
+
+                G4UIdirectory*           pDirectory_;
+                G4UIcmdWithoutParameter* pPrintCmd_;
+                G4UIcmdWithoutParameter* pResetCmd_;
+                G4UIcmdWithAnInteger*    pLengthCmd_;
+                G4UIcmdWithAString*      pFoldedCmd_;
+        };
+
+    } // namespace profile
+} // namespace latte
+#endif // NAVIGATIONPROFILERMESSENGER_HH
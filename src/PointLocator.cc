@@ -0,0 +1,171 @@
+#include "PointLocator.hh"
+
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TransportationManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4BooleanSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4ReflectedSolid.hh"
+
+#include <sstream>
+
+namespace latte {
+    namespace geometry {
+
+        PointLocator::ThreadState::ThreadState() : navigator(new G4Navigator), touchable(new G4TouchableHistory),
+        world(0), generation(0)
+        {;}
+
+
+        PointLocator::ThreadState::~ThreadState()
+        {
+            delete touchable;
+            delete navigator;
+        }
+
+
+        PointLocator::PointLocator() : state_(), mutex_(), world_(0), generation_(0), parallelSafe_(false)
+        {;}
+
+
+        PointLocator::~PointLocator()
+        {;}
+
+
+        void PointLocator::Invalidate()
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            world_ = 0;
+            ++generation_;
+        }
+
+
+        G4bool PointLocator::IsParallelSafe()
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            this->Refresh();
+            return parallelSafe_;
+        }
+
+
+        void PointLocator::Refresh()
+        {
+            //----- Called with mutex_ held. Picks up the tracking world and
+            // checks for volumes and solids whose navigation is not thread
+            // safe.
+            if(world_) return;
+
+            world_ = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+            parallelSafe_ = true;
+
+            G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+            for(G4PhysicalVolumeStore::const_iterator iter = store->begin(); iter != store->end(); ++iter) {
+                if((*iter)->IsReplicated()) {
+                    parallelSafe_ = false;
+                    return;
+                }
+            }
+
+            G4LogicalVolumeStore* logicals = G4LogicalVolumeStore::GetInstance();
+            for(G4LogicalVolumeStore::const_iterator iter = logicals->begin(); iter != logicals->end(); ++iter) {
+                if(!IsParallelSafe((*iter)->GetSolid())) {
+                    parallelSafe_ = false;
+                    return;
+                }
+            }
+        }
+
+
+        G4bool PointLocator::IsParallelSafe(const G4VSolid* solid)
+        {
+            //----- Faceted solids keep the last phi segment or surface hit
+            // in mutable members, updated by every Inside()
+            static const char* caching[] = {"G4Polycone", "G4Polyhedra", "G4GenericPolycone", "G4TwistedTubs",
+                "G4TwistedBox", "G4TwistedTrap", "G4TwistedTrd", 0};
+
+            if(!solid) return true;
+            G4String type = solid->GetEntityType();
+            for(const char** name = caching; *name; ++name) {
+                if(type == *name) return false;
+            }
+
+            if(const G4BooleanSolid* b = dynamic_cast<const G4BooleanSolid*>(solid)) {
+                return IsParallelSafe(b->GetConstituentSolid(0)) && IsParallelSafe(b->GetConstituentSolid(1));
+            }
+            if(const G4DisplacedSolid* d = dynamic_cast<const G4DisplacedSolid*>(solid)) {
+                return IsParallelSafe(d->GetConstituentMovedSolid());
+            }
+            if(const G4ReflectedSolid* r = dynamic_cast<const G4ReflectedSolid*>(solid)) {
+                return IsParallelSafe(r->GetConstituentMovedSolid());
+            }
+            return true;
+        }
+
+
+        PointLocator::ThreadState* PointLocator::Acquire()
+        {
+            this->Refresh();
+
+            //----- The navigator and touchable of an older geometry hold
+            // history into its deleted volumes, so start afresh
+            ThreadState* ts = state_.get();
+            if(!ts || ts->generation != generation_ || ts->world != world_) {
+                ts = new ThreadState;
+                state_.reset(ts);
+                ts->world = world_;
+                ts->generation = generation_;
+                if(world_) ts->navigator->SetWorldVolume(world_);
+            }
+            return ts;
+        }
+
+
+        void PointLocator::Locate(const G4ThreeVector& p, Location& out)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            ThreadState* ts = this->Acquire();
+            if(parallelSafe_) lock.unlock();
+
+            this->Fill(*ts, p, out);
+        }
+
+
+        void PointLocator::Fill(ThreadState& ts, const G4ThreeVector& p, Location& out)
+        {
+            out.volumes.clear();
+            out.copyNumbers.clear();
+            out.material = 0;
+            if(!ts.world) return;
+
+            //----- Relative search reuses the history of the previous lookup
+            // on this thread
+            ts.navigator->LocateGlobalPointAndUpdateTouchable(p, ts.touchable, true);
+
+            G4int depth = ts.touchable->GetHistoryDepth();
+            G4VPhysicalVolume* pv = ts.touchable->GetVolume();
+            if(!pv) return;
+
+            for(G4int i = depth; i >= 0; --i) {
+                out.volumes.push_back(ts.touchable->GetVolume(i));
+                out.copyNumbers.push_back(ts.touchable->GetReplicaNumber(i));
+            }
+            out.material = pv->GetLogicalVolume()->GetMaterial();
+        }
+
+
+        std::string PointLocator::Path(const Location& loc)
+        {
+            std::ostringstream path;
+            for(size_t i = 0; i < loc.volumes.size(); ++i) {
+                path<<"/"<<loc.volumes[i]->GetName()<<":"<<loc.copyNumbers[i];
+            }
+            return path.str();
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,126 @@
+#ifndef POINTLOCATOR_HH
+#define POINTLOCATOR_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Read-only point location in the current world, callable from
+//              several threads at once. Each thread gets its own G4Navigator
+//              and touchable, so consecutive lookups on a thread reuse the
+//              navigation history.
+//
+//              Replica and parameterised navigation in Geant4 writes to the
+//              shared physical/logical volumes, and some solids (polycones,
+//              polyhedra, twisted solids) cache state in Inside(), so for
+//              geometries containing them lookups are serialized.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <string>
+#include <vector>
+
+class G4Material;
+class G4Navigator;
+class G4VSolid;
+class G4TouchableHistory;
+class G4VPhysicalVolume;
+
+namespace latte {
+    namespace geometry {
+
+        class PointLocator
+        {
+            public:
+                //----- Result of a lookup, outermost volume first
+                struct Location
+                {
+                    std::vector<const G4VPhysicalVolume*> volumes;
+                    std::vector<G4int>                    copyNumbers;
+                    const G4Material*                     material;
+
+                    bool IsValid() const {return !volumes.empty();}
+                };
+
+            public:
+                PointLocator();
+                ~PointLocator();
+
+                //----- Locate p in the tracking world. Location is empty if
+                // there is no world or p lies outside it.
+                void Locate(const G4ThreeVector& p, Location& out);
+
+                //----- Locate [begin, end) in order on the calling thread,
+                // calling visitor(i, location) for each. Takes the lock once
+                // per range rather than once per point.
+                template<typename Visitor>
+                void LocateRange(const G4ThreeVector* begin, const G4ThreeVector* end, Visitor& visitor);
+
+                //----- Must be called, with no lookups in flight, whenever
+                // the geometry is rebuilt, and before the old one is deleted.
+                // DetectorConstructor does so for locators attached to it.
+                void Invalidate();
+
+                //----- False if lookups are serialized
+                G4bool IsParallelSafe();
+
+                //----- False if Inside() on solid, or any solid it is built
+                // from, writes to the solid
+                static G4bool IsParallelSafe(const G4VSolid* solid);
+
+                //----- Same form as TouchablePathIndex, "/World:0/Det:3"
+                static std::string Path(const Location& loc);
+
+            private:
+                struct ThreadState
+                {
+                    ThreadState();
+                    ~ThreadState();
+
+                    G4Navigator*        navigator;
+                    G4TouchableHistory* touchable;
+                    G4VPhysicalVolume*  world;
+                    unsigned long       generation;
+                };
+
+            private:
+                //----- Bind the calling thread's navigator to the current
+                // world, with mutex_ held
+                ThreadState* Acquire();
+                void Fill(ThreadState& ts, const G4ThreeVector& p, Location& out);
+                void Refresh();
+
+            private:
+                boost::thread_specific_ptr<ThreadState> state_;
+
+                boost::mutex       mutex_;
+                G4VPhysicalVolume* world_;
+                unsigned long      generation_;
+                G4bool             parallelSafe_;
+        };
+
+
+        template<typename Visitor>
+        void PointLocator::LocateRange(const G4ThreeVector* begin, const G4ThreeVector* end, Visitor& visitor)
+        {
+            Location loc;
+            boost::mutex::scoped_lock lock(mutex_);
+            ThreadState* ts = this->Acquire();
+            if(parallelSafe_) lock.unlock();
+
+            for(const G4ThreeVector* p = begin; p != end; ++p) {
+                this->Fill(*ts, *p, loc);
+                visitor(static_cast<size_t>(p - begin), loc);
+            }
+        }
+
+    } // namespace geometry
+} // namespace latte
+#endif // POINTLOCATOR_HH
@@ -0,0 +1,41 @@
+#ifndef POSIXIO_HH
+#define POSIXIO_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Helpers for writing to pipes and sockets.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string>
+
+namespace latte {
+    namespace io {
+
+        //----- Write all of data to fd, retrying short writes and EINTR.
+        // Sockets are written with MSG_NOSIGNAL, so a peer that has gone
+        // is an error rather than SIGPIPE. False on error.
+        inline bool WriteAll(int fd, const std::string& data, bool isSocket = false)
+        {
+            const char* p = data.data();
+            size_t left = data.size();
+            while(left) {
+                ssize_t n = isSocket ? ::send(fd, p, left, MSG_NOSIGNAL) : ::write(fd, p, left);
+                if(n < 0 && errno == EINTR) continue;
+                if(n <= 0) return false;
+                p += n;
+                left -= n;
+            }
+            return true;
+        }
+
+    } // namespace io
+} // namespace latte
+#endif // POSIXIO_HH
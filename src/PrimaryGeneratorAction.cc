@@ -1,20 +1,26 @@
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorActionMessenger.hh"
+#include "ScanGenerator.hh"
+#include "RandomizePolicy.hh"
 #include "G4GeneralParticleSource.hh"
+#include "G4ios.hh"
 
 namespace latte {
     namespace generator {
 
-        PrimaryGeneratorAction::PrimaryGeneratorAction() : G4VUserPrimaryGeneratorAction(), pGunImpl_(0)
-                                                           //(new G4GeneralParticleSource)
+        PrimaryGeneratorAction::PrimaryGeneratorAction() : G4VUserPrimaryGeneratorAction(), pGunImpl_(0),
+                                                           gunName_("gps"), pMessenger_(0), pSeeder_(0)
         {
             //----- Default Constructor
-            pGunImpl_ = new G4GeneralParticleSource();
+            pGunImpl_ = this->Create(gunName_);
+            pMessenger_ = new PrimaryGeneratorActionMessenger(this);
         }
 
 
         PrimaryGeneratorAction::~PrimaryGeneratorAction()
         {
             //----- Destructor
+            delete pMessenger_;
             delete pGunImpl_;
         }
 
@@ -22,6 +28,7 @@ namespace latte {
         void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
         {
             //----- add primary particles to the supplied G4Event
+            if(pSeeder_) pSeeder_->SeedEvent(anEvent);
             pGunImpl_->GeneratePrimaryVertex(anEvent);
         }
 
@@ -29,12 +36,17 @@ namespace latte {
         void PrimaryGeneratorAction::SelectPrimaryGenerator(const G4String& id)
         {
             // Change to a new primary generator
+            // Reselecting the current one keeps its settings, and avoids two
+            // generators registering the same UI commands.
+            if(pGunImpl_ && id == gunName_) return;
+
             // Use internal Create method as proxy for full Factory method
             G4VPrimaryGenerator* pNewPG = this->Create(id);
 
             if(pNewPG) {
                 delete pGunImpl_;
                 pGunImpl_ = pNewPG;
+                gunName_ = id;
             }
 
             return;
@@ -43,7 +55,16 @@ namespace latte {
 
         G4VPrimaryGenerator* PrimaryGeneratorAction::Create(const G4String& id)
         {
-            return new G4GeneralParticleSource();
+            //----- Return a new generator for id, or 0 if id is unknown
+            if(id == "gps") {
+                return new G4GeneralParticleSource();
+            }
+            else if(id == "scan") {
+                return new ScanGenerator();
+            }
+
+            G4cerr<<"gdmlview: unknown primary generator \""<<id<<"\""<<G4endl;
+            return 0;
         }
                 
 
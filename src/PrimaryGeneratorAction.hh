@@ -13,14 +13,20 @@
 
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4String.hh"
 
 class G4Event;
 class G4VPrimaryGenerator;
-class G4String;
 
 namespace latte {
+    namespace random {
+        class EventSeeder;
+    }
+
     namespace generator {
 
+        class PrimaryGeneratorActionMessenger;
+
         class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
         {
             public:
@@ -29,15 +35,24 @@ namespace latte {
 
                 virtual void GeneratePrimaries(G4Event* anEvent);
 
-                // Make primary generator selectable
+                // Make primary generator selectable, "gps" or "scan"
                 void SelectPrimaryGenerator(const G4String& id);
 
+                const G4String& GetPrimaryGeneratorName() const {return gunName_;}
+
+                // Reseed the engine per event before generating primaries,
+                // not owned
+                void SetEventSeeder(const latte::random::EventSeeder* seeder) {pSeeder_ = seeder;}
+
             private:
                 G4VPrimaryGenerator* Create(const G4String& id);
 
 
             private:
                 G4VPrimaryGenerator* pGunImpl_;
+                G4String             gunName_;
+                PrimaryGeneratorActionMessenger* pMessenger_;
+                const latte::random::EventSeeder* pSeeder_;
         };
 
     } // namespace generator
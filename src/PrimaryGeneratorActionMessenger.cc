@@ -0,0 +1,47 @@
+#include "PrimaryGeneratorActionMessenger.hh"
+
+#include "PrimaryGeneratorAction.hh"
+#include "G4UIcmdWithAString.hh"
+
+namespace latte {
+    namespace generator {
+
+        PrimaryGeneratorActionMessenger::PrimaryGeneratorActionMessenger(PrimaryGeneratorAction* messengedObject) : G4UImessenger(),
+        pMessengedAction_(messengedObject), pGeneratorCmd_(0)
+        {
+            //----- Default Constructor
+            pGeneratorCmd_ = new G4UIcmdWithAString("/gdmlview/generator",this);
+            pGeneratorCmd_->SetGuidance("select the primary generator");
+            pGeneratorCmd_->SetGuidance("gps  : General Particle Source, configured with /gps/");
+            pGeneratorCmd_->SetGuidance("scan : fast grid/raster/isotropic scans, configured with /gdmlview/scan/");
+            pGeneratorCmd_->SetParameterName("generator", false);
+            pGeneratorCmd_->SetCandidates("gps scan");
+            pGeneratorCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        PrimaryGeneratorActionMessenger::~PrimaryGeneratorActionMessenger()
+        {
+            //----- Destructor
+            delete pGeneratorCmd_;
+        }
+
+
+        void PrimaryGeneratorActionMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pGeneratorCmd_) {
+                pMessengedAction_->SelectPrimaryGenerator(args);
+            }
+        }
+
+
+        G4String PrimaryGeneratorActionMessenger::GetCurrentValue(G4UIcommand* cmd)
+        {
+            if ( cmd == pGeneratorCmd_) {
+                return pMessengedAction_->GetPrimaryGeneratorName();
+            }
+            return "";
+        }
+
+    } // namespace generator
+} // namespace latte
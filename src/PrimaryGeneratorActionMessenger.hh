@@ -0,0 +1,40 @@
+#ifndef LATTE_PRIMARYGENERATORACTIONMESSENGER_HH
+#define LATTE_PRIMARYGENERATORACTIONMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for PrimaryGeneratorAction
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIcmdWithAString;
+
+namespace latte {
+    namespace generator {
+
+        class PrimaryGeneratorAction;
+
+        class PrimaryGeneratorActionMessenger : public G4UImessenger
+        {
+            public:
+                PrimaryGeneratorActionMessenger(PrimaryGeneratorAction* messengedObject);
+                virtual ~PrimaryGeneratorActionMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+                G4String GetCurrentValue(G4UIcommand* cmd);
+
+            private:
+                PrimaryGeneratorAction* pMessengedAction_;
+
+                G4UIcmdWithAString*     pGeneratorCmd_;
+        };
+
+    } // namespace generator
+} // namespace latte
+#endif // LATTE_PRIMARYGENERATORACTIONMESSENGER_HH
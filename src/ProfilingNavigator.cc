@@ -0,0 +1,54 @@
+#include "ProfilingNavigator.hh"
+
+#include "G4TransportationManager.hh"
+
+namespace latte {
+    namespace profile {
+
+        ProfilingNavigator::ProfilingNavigator() : G4Navigator(), elapsed_(0), nComputeStep_(0), nLocate_(0)
+        {;}
+
+
+        ProfilingNavigator::~ProfilingNavigator()
+        {;}
+
+
+        G4double ProfilingNavigator::ComputeStep(const G4ThreeVector& pGlobalPoint,
+                                                 const G4ThreeVector& pDirection,
+                                                 const G4double pCurrentProposedStepLength,
+                                                 G4double& pNewSafety)
+        {
+            uint64_t t0 = WallClockNs();
+            G4double step = G4Navigator::ComputeStep(pGlobalPoint, pDirection, pCurrentProposedStepLength, pNewSafety);
+            elapsed_ += WallClockNs() - t0;
+            ++nComputeStep_;
+            return step;
+        }
+
+
+        G4VPhysicalVolume* ProfilingNavigator::LocateGlobalPointAndSetup(const G4ThreeVector& point,
+                                                                         const G4ThreeVector* direction,
+                                                                         const G4bool pRelativeSearch,
+                                                                         const G4bool ignoreDirection)
+        {
+            uint64_t t0 = WallClockNs();
+            G4VPhysicalVolume* pv = G4Navigator::LocateGlobalPointAndSetup(point, direction, pRelativeSearch, ignoreDirection);
+            elapsed_ += WallClockNs() - t0;
+            ++nLocate_;
+            return pv;
+        }
+
+
+        ProfilingNavigator* ProfilingNavigator::Install()
+        {
+            G4TransportationManager* tm = G4TransportationManager::GetTransportationManager();
+            G4VPhysicalVolume* world = tm->GetNavigatorForTracking()->GetWorldVolume();
+
+            ProfilingNavigator* nav = new ProfilingNavigator;
+            if(world) nav->SetWorldVolume(world);
+            tm->SetNavigatorForTracking(nav);
+            return nav;
+        }
+
+    } // namespace profile
+} // namespace latte
@@ -0,0 +1,79 @@
+#ifndef PROFILINGNAVIGATOR_HH
+#define PROFILINGNAVIGATOR_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: G4Navigator that times ComputeStep and point location. Time
+//              and call counts accumulate until drained by the profiler at
+//              the end of each step. Must be installed as the tracking
+//              navigator before the run manager is created, as the
+//              stepping manager and transportation cache the pointer.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4Navigator.hh"
+
+#include <stdint.h>
+#include <time.h>
+
+namespace latte {
+    namespace profile {
+
+        //----- Monotonic wall clock in ns
+        inline uint64_t WallClockNs()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec)*1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        //----- Interval in ns as ms, for reports
+        inline double Milliseconds(uint64_t ns)
+        {
+            return static_cast<double>(ns)*1e-6;
+        }
+
+        class ProfilingNavigator : public G4Navigator
+        {
+            public:
+                ProfilingNavigator();
+                virtual ~ProfilingNavigator();
+
+                //----- Timed overrides
+                virtual G4double ComputeStep(const G4ThreeVector& pGlobalPoint,
+                                             const G4ThreeVector& pDirection,
+                                             const G4double pCurrentProposedStepLength,
+                                             G4double& pNewSafety);
+
+                virtual G4VPhysicalVolume* LocateGlobalPointAndSetup(const G4ThreeVector& point,
+                                                                     const G4ThreeVector* direction = 0,
+                                                                     const G4bool pRelativeSearch = true,
+                                                                     const G4bool ignoreDirection = true);
+
+                //----- Return and reset counts accumulated since last drain
+                void Drain(uint64_t& ns, uint32_t& nComputeStep, uint32_t& nLocate)
+                {
+                    ns = elapsed_;
+                    nComputeStep = nComputeStep_;
+                    nLocate = nLocate_;
+                    elapsed_ = 0;
+                    nComputeStep_ = 0;
+                    nLocate_ = 0;
+                }
+
+                //----- Replace the tracking navigator with a new instance,
+                // returning it. The transportation manager owns it.
+                static ProfilingNavigator* Install();
+
+            private:
+                uint64_t elapsed_;
+                uint32_t nComputeStep_;
+                uint32_t nLocate_;
+        };
+
+    } // namespace profile
+} // namespace latte
+#endif // PROFILINGNAVIGATOR_HH
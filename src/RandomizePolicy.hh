@@ -7,41 +7,103 @@
 // Description: Policies for configuring the random number generator used
 //              in Geant4 simulations.
 //
+//              Each policy installs a Xoshiro256Engine and returns the
+//              master seed it used. EventSeeder then reseeds the engine
+//              from (master, run, event) before each event is generated,
+//              so an event's random sequence does not depend on which job
+//              or thread processes it, or in what order.
+//
 // Copyright (c) 2010 Ben Morgan, University of Warwick
 //
 // Redistribution and use is allowed according to the terms of the GPL license.
 //=============================================================================
 
 #include "Randomize.hh"
+#include "Xoshiro256Engine.hh"
+
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Event.hh"
+
+#include <ctime>
+#include <unistd.h>
 
 namespace latte {
     namespace random {
 
+        //----- Install a new Xoshiro256Engine seeded with master
+        inline uint64_t InstallEngine(uint64_t master)
+        {
+            CLHEP::HepRandom::setTheEngine(new Xoshiro256Engine(master));
+            return master;
+        }
+
+        //----- Irreproducible, but the returned seed can be fed back
+        // through FixedSeed to repeat a run
         struct SeedOnSystemTime
         {
-            static void configure()
+            static uint64_t configure()
             {
-                CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine);
-
-                long seeds[2];
                 time_t systime(time(NULL));
+                return InstallEngine(DeriveSeed(static_cast<uint64_t>(systime), static_cast<uint64_t>(getpid())));
+            }
+        };
 
-                seeds[0] = static_cast<long>(systime);
-                seeds[1] = static_cast<long>(systime*G4UniformRand());
+        struct FixedSeed
+        {
+            static uint64_t configure(uint64_t seed)
+            {
+                return InstallEngine(seed);
+            }
+        };
 
-                CLHEP::HepRandom::setTheSeeds(seeds);
+        //----- Independent stream per job of a batch, e.g. from the
+        // scheduler's array index
+        struct SeedFromJobIndex
+        {
+            static uint64_t configure(uint64_t baseSeed, uint64_t jobIndex)
+            {
+                return InstallEngine(DeriveSeed(baseSeed, jobIndex));
             }
         };
 
+
+        class EventSeeder
+        {
+            public:
+                explicit EventSeeder(uint64_t master) : master_(master) {;}
+
+                uint64_t GetMasterSeed() const {return master_;}
+
+                //----- Reseed the current engine for this event. Must run
+                // before primary generation.
+                void SeedEvent(const G4Event* anEvent) const
+                {
+                    const G4Run* aRun = G4RunManager::GetRunManager()->GetCurrentRun();
+                    uint64_t runID = aRun ? static_cast<uint64_t>(aRun->GetRunID()) : 0;
+                    uint64_t seed = DeriveSeed(master_, runID, static_cast<uint64_t>(anEvent->GetEventID()));
+
+                    Xoshiro256Engine* engine = dynamic_cast<Xoshiro256Engine*>(CLHEP::HepRandom::getTheEngine());
+                    if(engine) {
+                        engine->SetSeed64(seed);
+                    }
+                    else {
+                        CLHEP::HepRandom::setTheSeed(static_cast<long>(seed));
+                    }
+                }
+
+            private:
+                uint64_t master_;
+        };
+
     } // namespace random
 
     namespace random {
         typedef SeedOnSystemTime DefaultRandomizePolicy;
-        
+
     } // namespace random
-    
+
 } // namespace latte
 
 
 #endif // RANDOMIZEPOLICY_HH
-
@@ -0,0 +1,247 @@
+#include "ScanGenerator.hh"
+#include "ScanGeneratorMessenger.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "Randomize.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4ios.hh"
+
+#include <cmath>
+
+namespace latte {
+    namespace generator {
+
+        ScanGenerator::ScanGenerator() : G4VPrimaryGenerator(),
+        mode_(kGrid), origin_(),
+        thetaMin_(0.), thetaMax_(CLHEP::pi), phiMin_(0.), phiMax_(CLHEP::twopi),
+        nTheta_(90), nPhi_(180),
+        rasterDirection_(0., 0., 1.), rasterWidth_(1.*CLHEP::m), rasterHeight_(1.*CLHEP::m),
+        nU_(100), nV_(100),
+        perEvent_(100), particleName_("geantino"), energy_(1.*CLHEP::GeV),
+        pParticle_(0), dirty_(true), table_(), random_(), cursor_(0), pMessenger_(0)
+        {
+            //----- Default Constructor
+            pMessenger_ = new ScanGeneratorMessenger(this);
+        }
+
+
+        ScanGenerator::~ScanGenerator()
+        {
+            //----- Destructor
+            delete pMessenger_;
+        }
+
+
+        void ScanGenerator::GeneratePrimaryVertex(G4Event* anEvent)
+        {
+            G4ParticleDefinition* particle = this->GetParticle();
+            if(!particle) return;
+            if(dirty_) this->BuildTable();
+
+            //----- Point sources share one vertex, the raster needs one per
+            // start point
+            G4PrimaryVertex* vertex = 0;
+            if(mode_ != kRaster) {
+                vertex = new G4PrimaryVertex(origin_, 0.);
+                anEvent->AddPrimaryVertex(vertex);
+            }
+
+            if(mode_ == kIsotropic) {
+                random_.resize(2*perEvent_);
+                CLHEP::HepRandom::getTheEngine()->flatArray(2*perEvent_, &random_[0]);
+            }
+
+            for(G4int i = 0; i < perEvent_; ++i) {
+                G4ThreeVector direction;
+
+                if(mode_ == kIsotropic) {
+                    G4double cosTheta = 1. - 2.*random_[2*i];
+                    G4double sinTheta = std::sqrt(1. - cosTheta*cosTheta);
+                    G4double phi = CLHEP::twopi*random_[2*i+1];
+                    direction = G4ThreeVector(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+                }
+                else if(mode_ == kGrid) {
+                    direction = table_[cursor_];
+                    if(++cursor_ == table_.size()) cursor_ = 0;
+                }
+                else {
+                    direction = rasterDirection_;
+                    vertex = new G4PrimaryVertex(table_[cursor_], 0.);
+                    anEvent->AddPrimaryVertex(vertex);
+                    if(++cursor_ == table_.size()) cursor_ = 0;
+                }
+
+                G4PrimaryParticle* primary = new G4PrimaryParticle(particle);
+                primary->SetKineticEnergy(energy_);
+                primary->SetMomentumDirection(direction);
+                vertex->SetPrimary(primary);
+            }
+        }
+
+
+        void ScanGenerator::BuildTable()
+        {
+            //----- Grid and raster use bin centres, so a full 2pi phi range
+            // or pi theta range has no duplicated or polar points
+            table_.clear();
+            cursor_ = 0;
+
+            if(mode_ == kGrid) {
+                table_.reserve(nTheta_*nPhi_);
+                const G4double dTheta = (thetaMax_ - thetaMin_)/nTheta_;
+                const G4double dPhi = (phiMax_ - phiMin_)/nPhi_;
+
+                for(G4int i = 0; i < nTheta_; ++i) {
+                    const G4double theta = thetaMin_ + (i + 0.5)*dTheta;
+                    const G4double sinTheta = std::sin(theta);
+                    const G4double cosTheta = std::cos(theta);
+
+                    for(G4int j = 0; j < nPhi_; ++j) {
+                        const G4double phi = phiMin_ + (j + 0.5)*dPhi;
+                        table_.push_back(G4ThreeVector(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta));
+                    }
+                }
+            }
+            else if(mode_ == kRaster) {
+                table_.reserve(nU_*nV_);
+                const G4ThreeVector u = rasterDirection_.orthogonal().unit();
+                const G4ThreeVector v = rasterDirection_.cross(u).unit();
+                const G4double du = rasterWidth_/nU_;
+                const G4double dv = rasterHeight_/nV_;
+
+                for(G4int i = 0; i < nU_; ++i) {
+                    const G4ThreeVector pu = origin_ + (-0.5*rasterWidth_ + (i + 0.5)*du)*u;
+                    for(G4int j = 0; j < nV_; ++j) {
+                        table_.push_back(pu + (-0.5*rasterHeight_ + (j + 0.5)*dv)*v);
+                    }
+                }
+            }
+
+            dirty_ = false;
+        }
+
+
+        G4ParticleDefinition* ScanGenerator::GetParticle()
+        {
+            //----- Resolved lazily, the particle table may not be filled
+            // when the generator is created
+            if(!pParticle_) {
+                pParticle_ = G4ParticleTable::GetParticleTable()->FindParticle(particleName_);
+                if(!pParticle_) {
+                    G4cerr<<"gdmlview: scan generator: unknown particle \""<<particleName_<<"\""<<G4endl;
+                }
+            }
+            return pParticle_;
+        }
+
+
+        void ScanGenerator::SetMode(Mode m)
+        {
+            mode_ = m;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetOrigin(const G4ThreeVector& origin)
+        {
+            origin_ = origin;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetThetaRange(G4double thetaMin, G4double thetaMax)
+        {
+            thetaMin_ = thetaMin;
+            thetaMax_ = thetaMax;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetPhiRange(G4double phiMin, G4double phiMax)
+        {
+            phiMin_ = phiMin;
+            phiMax_ = phiMax;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetGridSize(G4int nTheta, G4int nPhi)
+        {
+            nTheta_ = nTheta > 0 ? nTheta : 1;
+            nPhi_ = nPhi > 0 ? nPhi : 1;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetRasterDirection(const G4ThreeVector& direction)
+        {
+            if(direction.mag2() == 0.) return;
+            rasterDirection_ = direction.unit();
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetRasterSize(G4double width, G4double height)
+        {
+            rasterWidth_ = width;
+            rasterHeight_ = height;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetRasterPoints(G4int nU, G4int nV)
+        {
+            nU_ = nU > 0 ? nU : 1;
+            nV_ = nV > 0 ? nV : 1;
+            dirty_ = true;
+        }
+
+
+        void ScanGenerator::SetPrimariesPerEvent(G4int n)
+        {
+            perEvent_ = n > 0 ? n : 1;
+        }
+
+
+        void ScanGenerator::SetParticle(const G4String& name)
+        {
+            particleName_ = name;
+            pParticle_ = 0;
+        }
+
+
+        void ScanGenerator::SetEnergy(G4double energy)
+        {
+            energy_ = energy;
+        }
+
+
+        void ScanGenerator::Print() const
+        {
+            static const char* modeNames[] = {"grid", "raster", "isotropic"};
+
+            G4cout<<"gdmlview scan generator:"<<G4endl
+                  <<"  mode        : "<<modeNames[mode_]<<G4endl
+                  <<"  particle    : "<<particleName_<<" at "<<energy_/CLHEP::MeV<<" MeV"<<G4endl
+                  <<"  per event   : "<<perEvent_<<G4endl
+                  <<"  origin (mm) : "<<origin_<<G4endl;
+
+            if(mode_ == kGrid) {
+                G4cout<<"  theta (deg) : "<<thetaMin_/CLHEP::deg<<" - "<<thetaMax_/CLHEP::deg<<" in "<<nTheta_<<G4endl
+                      <<"  phi (deg)   : "<<phiMin_/CLHEP::deg<<" - "<<phiMax_/CLHEP::deg<<" in "<<nPhi_<<G4endl
+                      <<"  table size  : "<<nTheta_*nPhi_<<G4endl;
+            }
+            else if(mode_ == kRaster) {
+                G4cout<<"  direction   : "<<rasterDirection_<<G4endl
+                      <<"  size (mm)   : "<<rasterWidth_<<" x "<<rasterHeight_<<G4endl
+                      <<"  points      : "<<nU_<<" x "<<nV_<<G4endl;
+            }
+        }
+
+    } // namespace generator
+} // namespace latte
@@ -0,0 +1,183 @@
+#include "ScanGeneratorMessenger.hh"
+
+#include "ScanGenerator.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWith3Vector.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+namespace latte {
+    namespace generator {
+
+        ScanGeneratorMessenger::ScanGeneratorMessenger(ScanGenerator* messengedObject) : G4UImessenger(),
+        pMessengedGenerator_(messengedObject), pDirectory_(0), pModeCmd_(0), pOriginCmd_(0),
+        pThetaCmd_(0), pPhiCmd_(0), pGridCmd_(0), pDirectionCmd_(0), pRasterSizeCmd_(0),
+        pRasterPointsCmd_(0), pPerEventCmd_(0), pParticleCmd_(0), pEnergyCmd_(0),
+        pRewindCmd_(0), pPrintCmd_(0)
+        {
+            //----- Default Constructor
+            pDirectory_ = new G4UIdirectory("/gdmlview/scan/");
+            pDirectory_->SetGuidance("Settings for the scan primary generator (/gdmlview/generator scan)");
+
+            pModeCmd_ = new G4UIcmdWithAString("/gdmlview/scan/mode",this);
+            pModeCmd_->SetGuidance("grid      : theta-phi grid of directions from the origin");
+            pModeCmd_->SetGuidance("raster    : parallel rays from a grid of points on a plane");
+            pModeCmd_->SetGuidance("isotropic : random isotropic directions from the origin");
+            pModeCmd_->SetParameterName("mode", false);
+            pModeCmd_->SetCandidates("grid raster isotropic");
+            pModeCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pOriginCmd_ = new G4UIcmdWith3VectorAndUnit("/gdmlview/scan/origin",this);
+            pOriginCmd_->SetGuidance("source point, or centre of the raster plane");
+            pOriginCmd_->SetParameterName("x", "y", "z", false);
+            pOriginCmd_->SetDefaultUnit("mm");
+            pOriginCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pThetaCmd_ = this->CreatePairCommand("/gdmlview/scan/theta", "theta range of the grid", 'd', "deg");
+            pPhiCmd_ = this->CreatePairCommand("/gdmlview/scan/phi", "phi range of the grid", 'd', "deg");
+            pGridCmd_ = this->CreatePairCommand("/gdmlview/scan/grid", "number of theta and phi bins", 'i', 0);
+
+            pDirectionCmd_ = new G4UIcmdWith3Vector("/gdmlview/scan/direction",this);
+            pDirectionCmd_->SetGuidance("direction of raster rays, the plane is normal to it");
+            pDirectionCmd_->SetParameterName("dx", "dy", "dz", false);
+            pDirectionCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pRasterSizeCmd_ = this->CreatePairCommand("/gdmlview/scan/rasterSize", "width and height of the raster", 'd', "mm");
+            pRasterPointsCmd_ = this->CreatePairCommand("/gdmlview/scan/rasterPoints", "number of raster points along width and height", 'i', 0);
+
+            pPerEventCmd_ = new G4UIcmdWithAnInteger("/gdmlview/scan/perEvent",this);
+            pPerEventCmd_->SetGuidance("number of primaries in each event");
+            pPerEventCmd_->SetParameterName("n", false);
+            pPerEventCmd_->SetRange("n > 0");
+            pPerEventCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pParticleCmd_ = new G4UIcmdWithAString("/gdmlview/scan/particle",this);
+            pParticleCmd_->SetGuidance("name of particle to shoot");
+            pParticleCmd_->SetParameterName("name", false);
+            pParticleCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pEnergyCmd_ = new G4UIcmdWithADoubleAndUnit("/gdmlview/scan/energy",this);
+            pEnergyCmd_->SetGuidance("kinetic energy of each primary");
+            pEnergyCmd_->SetParameterName("energy", false);
+            pEnergyCmd_->SetDefaultUnit("GeV");
+            pEnergyCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pRewindCmd_ = new G4UIcmdWithoutParameter("/gdmlview/scan/rewind",this);
+            pRewindCmd_->SetGuidance("restart the grid or raster from its first point");
+            pRewindCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pPrintCmd_ = new G4UIcmdWithoutParameter("/gdmlview/scan/print",this);
+            pPrintCmd_->SetGuidance("print scan generator settings");
+            pPrintCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        ScanGeneratorMessenger::~ScanGeneratorMessenger()
+        {
+            //----- Destructor
+            delete pPrintCmd_;
+            delete pRewindCmd_;
+            delete pEnergyCmd_;
+            delete pParticleCmd_;
+            delete pPerEventCmd_;
+            delete pRasterPointsCmd_;
+            delete pRasterSizeCmd_;
+            delete pDirectionCmd_;
+            delete pGridCmd_;
+            delete pPhiCmd_;
+            delete pThetaCmd_;
+            delete pOriginCmd_;
+            delete pModeCmd_;
+            delete pDirectory_;
+        }
+
+
+        G4UIcommand* ScanGeneratorMessenger::CreatePairCommand(const char* path, const char* guidance,
+                                                               char type, const char* defaultUnit)
+        {
+            //----- Two value command, with a trailing unit for doubles
+            G4UIcommand* cmd = new G4UIcommand(path,this);
+            cmd->SetGuidance(guidance);
+            cmd->SetParameter(new G4UIparameter("first", type, false));
+            cmd->SetParameter(new G4UIparameter("second", type, false));
+            if(defaultUnit) {
+                G4UIparameter* unit = new G4UIparameter("unit", 's', true);
+                unit->SetDefaultValue(defaultUnit);
+                cmd->SetParameter(unit);
+            }
+            cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+            return cmd;
+        }
+
+
+        void ScanGeneratorMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            std::istringstream is(args);
+
+            if ( cmd == pModeCmd_) {
+                if(args == "raster") {
+                    pMessengedGenerator_->SetMode(ScanGenerator::kRaster);
+                }
+                else if(args == "isotropic") {
+                    pMessengedGenerator_->SetMode(ScanGenerator::kIsotropic);
+                }
+                else {
+                    pMessengedGenerator_->SetMode(ScanGenerator::kGrid);
+                }
+            }
+            else if ( cmd == pOriginCmd_) {
+                pMessengedGenerator_->SetOrigin(pOriginCmd_->GetNew3VectorValue(args));
+            }
+            else if ( cmd == pThetaCmd_ || cmd == pPhiCmd_ || cmd == pRasterSizeCmd_) {
+                G4double first, second;
+                G4String unit;
+                is>>first>>second>>unit;
+                G4double scale = G4UIcommand::ValueOf(unit);
+                if(cmd == pThetaCmd_) {
+                    pMessengedGenerator_->SetThetaRange(first*scale, second*scale);
+                }
+                else if(cmd == pPhiCmd_) {
+                    pMessengedGenerator_->SetPhiRange(first*scale, second*scale);
+                }
+                else {
+                    pMessengedGenerator_->SetRasterSize(first*scale, second*scale);
+                }
+            }
+            else if ( cmd == pGridCmd_ || cmd == pRasterPointsCmd_) {
+                G4int first, second;
+                is>>first>>second;
+                if(cmd == pGridCmd_) {
+                    pMessengedGenerator_->SetGridSize(first, second);
+                }
+                else {
+                    pMessengedGenerator_->SetRasterPoints(first, second);
+                }
+            }
+            else if ( cmd == pDirectionCmd_) {
+                pMessengedGenerator_->SetRasterDirection(pDirectionCmd_->GetNew3VectorValue(args));
+            }
+            else if ( cmd == pPerEventCmd_) {
+                pMessengedGenerator_->SetPrimariesPerEvent(pPerEventCmd_->GetNewIntValue(args));
+            }
+            else if ( cmd == pParticleCmd_) {
+                pMessengedGenerator_->SetParticle(args);
+            }
+            else if ( cmd == pEnergyCmd_) {
+                pMessengedGenerator_->SetEnergy(pEnergyCmd_->GetNewDoubleValue(args));
+            }
+            else if ( cmd == pRewindCmd_) {
+                pMessengedGenerator_->Rewind();
+            }
+            else if ( cmd == pPrintCmd_) {
+                pMessengedGenerator_->Print();
+            }
+        }
+
+    } // namespace generator
+} // namespace latte
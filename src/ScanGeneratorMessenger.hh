@@ -0,0 +1,62 @@
+#ifndef LATTE_SCANGENERATORMESSENGER_HH
+#define LATTE_SCANGENERATORMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for ScanGenerator
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWith3Vector;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcmdWithoutParameter;
+
+namespace latte {
+    namespace generator {
+
+        class ScanGenerator;
+
+        class ScanGeneratorMessenger : public G4UImessenger
+        {
+            public:
+                ScanGeneratorMessenger(ScanGenerator* messengedObject);
+                virtual ~ScanGeneratorMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                G4UIcommand* CreatePairCommand(const char* path, const char* guidance,
+                                               char type, const char* defaultUnit);
+
+            private:
+                ScanGenerator*             pMessengedGenerator_;
+
+                G4UIdirectory*             pDirectory_;
+                G4UIcmdWithAString*        pModeCmd_;
+                G4UIcmdWith3VectorAndUnit* pOriginCmd_;
+                G4UIcommand*               pThetaCmd_;
+                G4UIcommand*               pPhiCmd_;
+                G4UIcommand*               pGridCmd_;
+                G4UIcmdWith3Vector*        pDirectionCmd_;
+                G4UIcommand*               pRasterSizeCmd_;
+                G4UIcommand*               pRasterPointsCmd_;
+                G4UIcmdWithAnInteger*      pPerEventCmd_;
+                G4UIcmdWithAString*        pParticleCmd_;
+                G4UIcmdWithADoubleAndUnit* pEnergyCmd_;
+                G4UIcmdWithoutParameter*   pRewindCmd_;
+                G4UIcmdWithoutParameter*   pPrintCmd_;
+        };
+
+    } // namespace generator
+} // namespace latte
+#endif // LATTE_SCANGENERATORMESSENGER_HH
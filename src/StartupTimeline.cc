@@ -0,0 +1,104 @@
+#include "StartupTimeline.hh"
+
+#include "ProfilingNavigator.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+    const size_t kBarWidth = 40;
+}
+
+namespace latte {
+    namespace profile {
+
+        StartupTimeline::Phase::Phase(const char* lane, const char* name) : lane_(lane), name_(name),
+        start_(WallClockNs())
+        {;}
+
+
+        StartupTimeline::Phase::~Phase()
+        {
+            StartupTimeline::Instance().Record(lane_, name_, start_, WallClockNs());
+        }
+
+
+        StartupTimeline& StartupTimeline::Instance()
+        {
+            static StartupTimeline timeline;
+            return timeline;
+        }
+
+
+        StartupTimeline::StartupTimeline() : mutex_(), origin_(WallClockNs()), closed_(false), entries_()
+        {;}
+
+
+        void StartupTimeline::Record(const std::string& lane, const std::string& name, uint64_t start, uint64_t end)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            if(closed_) return;
+
+            Entry e;
+            e.lane = lane;
+            e.name = name;
+            e.start = start > origin_ ? start - origin_ : 0;
+            e.end = end > origin_ ? end - origin_ : 0;
+            entries_.push_back(e);
+        }
+
+
+        void StartupTimeline::Close()
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            closed_ = true;
+        }
+
+
+        bool StartupTimeline::StartsBefore(const Entry& a, const Entry& b)
+        {
+            return a.start < b.start;
+        }
+
+
+        void StartupTimeline::Print(std::ostream& os) const
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            if(entries_.empty()) return;
+
+            //----- Order by start, so each lane reads top to bottom
+            std::vector<Entry> entries(entries_);
+            std::stable_sort(entries.begin(), entries.end(), &StartupTimeline::StartsBefore);
+
+            uint64_t last(0);
+            size_t laneWidth(4), nameWidth(5);
+            for(size_t i = 0; i < entries.size(); ++i) {
+                last = std::max(last, entries[i].end);
+                laneWidth = std::max(laneWidth, entries[i].lane.size());
+                nameWidth = std::max(nameWidth, entries[i].name.size());
+            }
+            if(last == 0) last = 1;
+
+            std::ios_base::fmtflags flags(os.flags());
+            os<<"gdmlview: startup timeline, ms from start"<<std::endl;
+            os<<"  "<<std::left<<std::setw(laneWidth)<<"lane"<<"  "<<std::setw(nameWidth)<<"phase"
+                <<std::right<<std::setw(10)<<"start"<<std::setw(10)<<"end"<<std::endl;
+
+            for(std::vector<Entry>::const_iterator e = entries.begin(); e != entries.end(); ++e) {
+                size_t from = static_cast<size_t>(kBarWidth*e->start/last);
+                size_t to = std::max(from + 1, static_cast<size_t>(kBarWidth*e->end/last));
+                to = std::min(to, kBarWidth);
+                from = std::min(from, to - 1);
+
+                os<<"  "<<std::left<<std::setw(laneWidth)<<e->lane<<"  "<<std::setw(nameWidth)<<e->name
+                    <<std::right<<std::fixed<<std::setprecision(1)
+                    <<std::setw(10)<<Milliseconds(e->start)<<std::setw(10)<<Milliseconds(e->end)
+                    <<"  |"<<std::string(from, ' ')<<std::string(to - from, '#')<<std::string(kBarWidth - to, ' ')<<"|"
+                    <<std::endl;
+            }
+            os.flags(flags);
+        }
+
+    } // namespace profile
+} // namespace latte
@@ -0,0 +1,74 @@
+#ifndef STARTUPTIMELINE_HH
+#define STARTUPTIMELINE_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Wall clock record of the startup phases of gdmlview, per
+//              thread ("lane"), printed as a text Gantt chart so that the
+//              overlap of geometry construction with session, physics and
+//              visualization setup can be seen.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <boost/thread/mutex.hpp>
+#include <iosfwd>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace latte {
+    namespace profile {
+
+        class StartupTimeline
+        {
+            public:
+                //----- Times phases from construction to destruction
+                class Phase
+                {
+                    public:
+                        Phase(const char* lane, const char* name);
+                        ~Phase();
+
+                    private:
+                        const char* lane_;
+                        const char* name_;
+                        uint64_t    start_;
+                };
+
+            public:
+                //----- Started on first use, so call early in main
+                static StartupTimeline& Instance();
+
+                void Record(const std::string& lane, const std::string& name, uint64_t start, uint64_t end);
+
+                //----- Stop recording, later geometry rebuilds are not startup
+                void Close();
+
+                void Print(std::ostream& os) const;
+
+            private:
+                StartupTimeline();
+
+                struct Entry
+                {
+                    std::string lane;
+                    std::string name;
+                    uint64_t    start;
+                    uint64_t    end;
+                };
+
+                static bool StartsBefore(const Entry& a, const Entry& b);
+
+            private:
+                mutable boost::mutex mutex_;
+                uint64_t             origin_;
+                bool                 closed_;
+                std::vector<Entry>   entries_;
+        };
+
+    } // namespace profile
+} // namespace latte
+#endif // STARTUPTIMELINE_HH
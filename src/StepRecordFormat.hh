@@ -0,0 +1,103 @@
+#ifndef STEPRECORDFORMAT_HH
+#define STEPRECORDFORMAT_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: On-disk layout of gdmlview step record files. Shared by the
+//              writer and reader, and free of Geant4 dependencies so that
+//              analysis code can use it directly.
+//
+//              file    := FileHeader chunk* dictionary index Footer
+//              chunk   := ChunkHeader column[kNumberOfColumns]
+//              column  := nRecords values, zero padded to 8 bytes
+//              dict    := u32 n, (u32 length, char[length])*n  (volumes)
+//                         u32 n, (u32 length, char[length])*n  (materials)
+//              index   := ChunkIndexEntry*nChunks
+//
+//              All values are in host byte order. Lengths are in mm.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace latte {
+    namespace steprecord {
+
+        const char     kFileMagic[8]   = {'G','D','V','S','T','E','P','\0'};
+        const char     kFooterMagic[8] = {'G','D','V','S','T','E','P','E'};
+        const char     kChunkMagic[4]  = {'C','H','N','K'};
+        const uint32_t kFormatVersion  = 1;
+
+        //----- Columns in the order they appear in each chunk
+        enum Column {
+            kEventID = 0,
+            kTrackID,
+            kVolumeID,
+            kMaterialID,
+            kPreX,
+            kPreY,
+            kPreZ,
+            kPostX,
+            kPostY,
+            kPostZ,
+            kStepLength,
+            kNumberOfColumns
+        };
+
+        //----- Size in bytes of one value in the given column
+        inline size_t ColumnWidth(int column)
+        {
+            return column < kPreX ? sizeof(int32_t) : sizeof(double);
+        }
+
+        //----- Size in bytes of a column of n values, including padding
+        inline size_t ColumnBytes(int column, uint32_t n)
+        {
+            size_t raw = ColumnWidth(column)*n;
+            return (raw + 7) & ~static_cast<size_t>(7);
+        }
+
+        struct FileHeader
+        {
+            char     magic[8];
+            uint32_t version;
+            uint32_t reserved;
+        };
+
+        struct ChunkHeader
+        {
+            char     magic[4];
+            uint32_t nRecords;
+        };
+
+        //----- Size in bytes of a chunk of n records, header included
+        inline uint64_t ChunkBytes(uint32_t n)
+        {
+            uint64_t bytes = sizeof(ChunkHeader);
+            for(int col = 0; col < kNumberOfColumns; ++col) bytes += ColumnBytes(col, n);
+            return bytes;
+        }
+
+        struct ChunkIndexEntry
+        {
+            uint64_t offset;
+            uint32_t nRecords;
+            uint32_t reserved;
+        };
+
+        struct Footer
+        {
+            uint64_t dictionaryOffset;
+            uint64_t indexOffset;
+            uint64_t nChunks;
+            uint64_t nRecords;
+            char     magic[8];
+        };
+
+    } // namespace steprecord
+} // namespace latte
+#endif // STEPRECORDFORMAT_HH
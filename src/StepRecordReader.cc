@@ -0,0 +1,157 @@
+#include "StepRecordReader.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace latte {
+    namespace steprecord {
+
+        StepRecordReader::StepRecordReader(const std::string& fileName) : fileName_(fileName),
+        pData_(0), size_(0), nRecords_(0), index_(), volumes_(), materials_()
+        {
+            //----- Map the whole file read only
+            int fd = ::open(fileName.c_str(), O_RDONLY);
+            if(fd < 0) this->Fail("cannot open file");
+
+            struct stat st;
+            if(::fstat(fd, &st) != 0) {
+                ::close(fd);
+                this->Fail("cannot stat file");
+            }
+            size_ = static_cast<size_t>(st.st_size);
+
+            if(size_ < sizeof(FileHeader) + sizeof(Footer)) {
+                ::close(fd);
+                this->Fail("file too small");
+            }
+
+            void* mapping = ::mmap(0, size_, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if(mapping == MAP_FAILED) this->Fail("mmap failed");
+            pData_ = static_cast<const char*>(mapping);
+
+            //----- Validate header and footer. The footer is only written on
+            // a clean close.
+            FileHeader header;
+            std::memcpy(&header, pData_, sizeof(header));
+            if(std::memcmp(header.magic, kFileMagic, sizeof(header.magic)) != 0) this->Fail("not a step record file");
+            if(header.version != kFormatVersion) this->Fail("unsupported format version");
+
+            Footer footer;
+            std::memcpy(&footer, pData_ + size_ - sizeof(footer), sizeof(footer));
+            if(std::memcmp(footer.magic, kFooterMagic, sizeof(footer.magic)) != 0) this->Fail("missing footer, file was not closed");
+
+            const char* end = pData_ + size_ - sizeof(footer);
+            const uint64_t indexSpace = static_cast<uint64_t>(end - pData_);
+            if(footer.indexOffset > indexSpace ||
+               footer.nChunks > (indexSpace - footer.indexOffset)/sizeof(ChunkIndexEntry)) {
+                this->Fail("corrupt chunk index");
+            }
+            if(footer.dictionaryOffset < sizeof(FileHeader) || footer.dictionaryOffset > footer.indexOffset) {
+                this->Fail("corrupt dictionary");
+            }
+
+            //----- Index entries are not necessarily aligned, so copy them
+            index_.resize(footer.nChunks);
+            if(footer.nChunks) {
+                std::memcpy(&index_[0], pData_ + footer.indexOffset, footer.nChunks*sizeof(ChunkIndexEntry));
+            }
+            nRecords_ = footer.nRecords;
+
+            //----- Every chunk must lie between the header and the
+            // dictionaries, 8 byte aligned for its columns, and start with a
+            // chunk header matching its entry
+            uint64_t nIndexed(0);
+            for(std::vector<ChunkIndexEntry>::const_iterator entry = index_.begin(); entry != index_.end(); ++entry) {
+                if(entry->offset < sizeof(FileHeader) || entry->offset % 8 != 0 ||
+                   entry->offset > footer.dictionaryOffset ||
+                   ChunkBytes(entry->nRecords) > footer.dictionaryOffset - entry->offset) {
+                    this->Fail("corrupt chunk index");
+                }
+
+                ChunkHeader chunk;
+                std::memcpy(&chunk, pData_ + entry->offset, sizeof(chunk));
+                if(std::memcmp(chunk.magic, kChunkMagic, sizeof(chunk.magic)) != 0 || chunk.nRecords != entry->nRecords) {
+                    this->Fail("corrupt chunk header");
+                }
+                nIndexed += entry->nRecords;
+            }
+            if(nIndexed != nRecords_) this->Fail("record count does not match chunk index");
+
+            const char* dictEnd = pData_ + footer.indexOffset;
+            const char* p = this->ReadDictionary(pData_ + footer.dictionaryOffset, dictEnd, volumes_);
+            this->ReadDictionary(p, dictEnd, materials_);
+        }
+
+
+        StepRecordReader::~StepRecordReader()
+        {
+            if(pData_) ::munmap(const_cast<char*>(pData_), size_);
+        }
+
+
+        ChunkView StepRecordReader::GetChunk(size_t i) const
+        {
+            const ChunkIndexEntry& entry = index_.at(i);
+            const char* p = pData_ + entry.offset + sizeof(ChunkHeader);
+            const uint32_t n = entry.nRecords;
+
+            const char* columns[kNumberOfColumns];
+            for(int col = 0; col < kNumberOfColumns; ++col) {
+                columns[col] = p;
+                p += ColumnBytes(col, n);
+            }
+
+            ChunkView v;
+            v.nRecords   = n;
+            v.eventID    = reinterpret_cast<const int32_t*>(columns[kEventID]);
+            v.trackID    = reinterpret_cast<const int32_t*>(columns[kTrackID]);
+            v.volumeID   = reinterpret_cast<const uint32_t*>(columns[kVolumeID]);
+            v.materialID = reinterpret_cast<const uint32_t*>(columns[kMaterialID]);
+            v.preX       = reinterpret_cast<const double*>(columns[kPreX]);
+            v.preY       = reinterpret_cast<const double*>(columns[kPreY]);
+            v.preZ       = reinterpret_cast<const double*>(columns[kPreZ]);
+            v.postX      = reinterpret_cast<const double*>(columns[kPostX]);
+            v.postY      = reinterpret_cast<const double*>(columns[kPostY]);
+            v.postZ      = reinterpret_cast<const double*>(columns[kPostZ]);
+            v.stepLength = reinterpret_cast<const double*>(columns[kStepLength]);
+            return v;
+        }
+
+
+        const char* StepRecordReader::ReadDictionary(const char* p, const char* end, std::vector<std::string>& d)
+        {
+            uint32_t n = 0;
+            if(p + sizeof(n) > end) this->Fail("truncated dictionary");
+            std::memcpy(&n, p, sizeof(n));
+            p += sizeof(n);
+
+            d.reserve(n);
+            for(uint32_t i = 0; i < n; ++i) {
+                uint32_t length = 0;
+                if(p + sizeof(length) > end) this->Fail("truncated dictionary");
+                std::memcpy(&length, p, sizeof(length));
+                p += sizeof(length);
+                if(p + length > end) this->Fail("truncated dictionary");
+                d.push_back(std::string(p, length));
+                p += length;
+            }
+            return p;
+        }
+
+
+        void StepRecordReader::Fail(const std::string& what)
+        {
+            if(pData_) {
+                ::munmap(const_cast<char*>(pData_), size_);
+                pData_ = 0;
+            }
+            throw std::runtime_error("StepRecordReader: " + fileName_ + ": " + what);
+        }
+
+    } // namespace steprecord
+} // namespace latte
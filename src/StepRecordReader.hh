@@ -0,0 +1,78 @@
+#ifndef STEPRECORDREADER_HH
+#define STEPRECORDREADER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Memory mapped reader for gdmlview step record files. Columns
+//              are exposed as pointers straight into the mapping, so
+//              reading a chunk costs nothing until the data is touched.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "StepRecordFormat.hh"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace latte {
+    namespace steprecord {
+
+        //----- View of one chunk, valid while the reader is open
+        struct ChunkView
+        {
+            uint32_t        nRecords;
+            const int32_t*  eventID;
+            const int32_t*  trackID;
+            const uint32_t* volumeID;
+            const uint32_t* materialID;
+            const double*   preX;
+            const double*   preY;
+            const double*   preZ;
+            const double*   postX;
+            const double*   postY;
+            const double*   postZ;
+            const double*   stepLength;
+        };
+
+        class StepRecordReader
+        {
+            public:
+                //----- Throws std::runtime_error if the file cannot be
+                // mapped or is not a complete step record file
+                explicit StepRecordReader(const std::string& fileName);
+                ~StepRecordReader();
+
+                size_t GetNumberOfChunks() const {return index_.size();}
+                uint64_t GetNumberOfRecords() const {return nRecords_;}
+
+                ChunkView GetChunk(size_t i) const;
+
+                //----- Dictionaries, indexed by volumeID/materialID
+                const std::vector<std::string>& GetVolumeNames() const {return volumes_;}
+                const std::vector<std::string>& GetMaterialNames() const {return materials_;}
+
+            private:
+                StepRecordReader(const StepRecordReader&);
+                StepRecordReader& operator=(const StepRecordReader&);
+
+                const char* ReadDictionary(const char* p, const char* end, std::vector<std::string>& d);
+                void Fail(const std::string& what);
+
+            private:
+                std::string fileName_;
+                const char* pData_;
+                size_t      size_;
+                uint64_t    nRecords_;
+
+                std::vector<ChunkIndexEntry> index_;
+                std::vector<std::string>     volumes_;
+                std::vector<std::string>     materials_;
+        };
+
+    } // namespace steprecord
+} // namespace latte
+#endif // STEPRECORDREADER_HH
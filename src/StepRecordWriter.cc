@@ -0,0 +1,193 @@
+#include "StepRecordWriter.hh"
+
+#include <cstring>
+
+namespace latte {
+    namespace steprecord {
+
+        StepRecordWriter::StepRecordWriter() : pFile_(0), chunkSize_(0), nRecords_(0),
+        pCurrent_(), free_(), full_(), stopping_(false),
+        mutex_(), freeReady_(), fullReady_(), writer_(), index_(), offset_(0), failed_(false)
+        {;}
+
+
+        StepRecordWriter::~StepRecordWriter()
+        {
+            //----- Destructor, finish the file without dictionaries if the
+            // client forgot to
+            if(pFile_) this->Close(Dictionary(), Dictionary());
+        }
+
+
+        bool StepRecordWriter::Open(const std::string& fileName, uint32_t chunkSize, size_t nBuffers)
+        {
+            if(pFile_) return false;
+
+            pFile_ = std::fopen(fileName.c_str(), "wb");
+            if(!pFile_) return false;
+
+            //----- Large stdio buffer, chunks are written in a few big calls
+            std::setvbuf(pFile_, 0, _IOFBF, 1u<<20);
+
+            chunkSize_ = chunkSize > 0 ? chunkSize : 1;
+            nRecords_ = 0;
+            stopping_ = false;
+            failed_ = false;
+            index_.clear();
+            free_.clear();
+            full_.clear();
+
+            for(size_t i = 0; i < (nBuffers > 1 ? nBuffers : 2); ++i) {
+                ChunkPtr c(new Chunk);
+                c->n = 0;
+                for(int j = 0; j < kPreX; ++j) c->int32Columns[j].resize(chunkSize_);
+                for(int j = 0; j < kNumberOfColumns - kPreX; ++j) c->doubleColumns[j].resize(chunkSize_);
+                free_.push_back(c);
+            }
+            pCurrent_ = free_.front();
+            free_.pop_front();
+
+            FileHeader header;
+            std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+            header.version = kFormatVersion;
+            header.reserved = 0;
+            offset_ = 0;
+            this->Write(&header, sizeof(header));
+
+            writer_ = boost::thread(&StepRecordWriter::WriteLoop, this);
+            return true;
+        }
+
+
+        bool StepRecordWriter::Close(const Dictionary& volumes, const Dictionary& materials)
+        {
+            if(!pFile_) return false;
+
+            //----- Hand over the partial chunk and let the writer drain
+            if(pCurrent_->n > 0) this->Submit();
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                stopping_ = true;
+            }
+            fullReady_.notify_one();
+            writer_.join();
+
+            Footer footer;
+            footer.dictionaryOffset = offset_;
+            this->WriteDictionary(volumes);
+            this->WriteDictionary(materials);
+
+            footer.indexOffset = offset_;
+            if(!index_.empty()) this->Write(&index_[0], sizeof(ChunkIndexEntry)*index_.size());
+            footer.nChunks = index_.size();
+            footer.nRecords = nRecords_;
+            std::memcpy(footer.magic, kFooterMagic, sizeof(footer.magic));
+
+            //----- Without a footer the file reads as incomplete, rather
+            // than indexing chunks that never reached the disk
+            if(!failed_) this->Write(&footer, sizeof(footer));
+
+            if(std::fclose(pFile_) != 0) failed_ = true;
+            pFile_ = 0;
+
+            pCurrent_.reset();
+            free_.clear();
+            return !failed_;
+        }
+
+
+        void StepRecordWriter::Submit()
+        {
+            //----- Queue the current chunk and take a free one, waiting only
+            // if every buffer is still queued for writing
+            nRecords_ += pCurrent_->n;
+
+            boost::mutex::scoped_lock lock(mutex_);
+            full_.push_back(pCurrent_);
+            fullReady_.notify_one();
+
+            while(free_.empty()) freeReady_.wait(lock);
+            pCurrent_ = free_.front();
+            free_.pop_front();
+            pCurrent_->n = 0;
+        }
+
+
+        void StepRecordWriter::WriteLoop()
+        {
+            for(;;) {
+                ChunkPtr c;
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    while(full_.empty() && !stopping_) fullReady_.wait(lock);
+                    if(full_.empty()) return;
+                    c = full_.front();
+                    full_.pop_front();
+                }
+
+                //----- Write outside the lock so the producer keeps filling
+                this->WriteChunk(*c);
+
+                {
+                    boost::mutex::scoped_lock lock(mutex_);
+                    free_.push_back(c);
+                }
+                freeReady_.notify_one();
+            }
+        }
+
+
+        void StepRecordWriter::WriteChunk(const Chunk& c)
+        {
+            static const char padding[8] = {0,0,0,0,0,0,0,0};
+
+            //----- Once a write has failed the file is lost, so later
+            // chunks are only counted
+            if(failed_) return;
+
+            ChunkIndexEntry entry;
+            entry.offset = offset_;
+            entry.nRecords = c.n;
+            entry.reserved = 0;
+
+            ChunkHeader header;
+            std::memcpy(header.magic, kChunkMagic, sizeof(header.magic));
+            header.nRecords = c.n;
+            this->Write(&header, sizeof(header));
+
+            for(int col = 0; col < kNumberOfColumns; ++col) {
+                const void* data = col < kPreX ? static_cast<const void*>(&c.int32Columns[col][0])
+                                               : static_cast<const void*>(&c.doubleColumns[col - kPreX][0]);
+                size_t raw = ColumnWidth(col)*c.n;
+                size_t padded = ColumnBytes(col, c.n);
+
+                this->Write(data, raw);
+                if(padded > raw) this->Write(padding, padded - raw);
+            }
+            if(!failed_) index_.push_back(entry);
+        }
+
+
+        void StepRecordWriter::WriteDictionary(const Dictionary& d)
+        {
+            uint32_t n = static_cast<uint32_t>(d.size());
+            this->Write(&n, sizeof(n));
+
+            for(Dictionary::const_iterator iter = d.begin(); iter != d.end(); ++iter) {
+                uint32_t length = static_cast<uint32_t>(iter->size());
+                this->Write(&length, sizeof(length));
+                this->Write(iter->data(), length);
+            }
+        }
+
+
+        void StepRecordWriter::Write(const void* data, size_t size)
+        {
+            //----- The first short write sticks, and is reported by Close()
+            if(failed_ || size == 0) return;
+            if(std::fwrite(data, 1, size, pFile_) != size) failed_ = true;
+            offset_ += size;
+        }
+
+    } // namespace steprecord
+} // namespace latte
@@ -0,0 +1,120 @@
+#ifndef STEPRECORDWRITER_HH
+#define STEPRECORDWRITER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Buffered, asynchronous writer of columnar step record files.
+//              Records are collected into fixed size chunks which are
+//              handed to a background thread for writing. A small pool of
+//              chunks bounds memory; the producer only waits if the disk
+//              cannot keep up.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "StepRecordFormat.hh"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace latte {
+    namespace steprecord {
+
+        struct StepRecord
+        {
+            int32_t  eventID;
+            int32_t  trackID;
+            uint32_t volumeID;
+            uint32_t materialID;
+            double   pre[3];
+            double   post[3];
+            double   stepLength;
+        };
+
+        class StepRecordWriter
+        {
+            public:
+                typedef std::vector<std::string> Dictionary;
+
+            public:
+                StepRecordWriter();
+                ~StepRecordWriter();
+
+                //----- Returns false if the file cannot be created
+                bool Open(const std::string& fileName, uint32_t chunkSize = 1u<<16, size_t nBuffers = 4);
+
+                //----- Flush outstanding chunks and write the dictionaries,
+                // index and footer. Returns false if any write failed (e.g.
+                // the disk filled up), in which case no footer is written
+                // and readers reject the file.
+                bool Close(const Dictionary& volumes, const Dictionary& materials);
+
+                bool IsOpen() const {return pFile_ != 0;}
+
+                void Append(const StepRecord& record)
+                {
+                    Chunk& c = *pCurrent_;
+                    c.int32Columns[kEventID][c.n]    = record.eventID;
+                    c.int32Columns[kTrackID][c.n]    = record.trackID;
+                    c.int32Columns[kVolumeID][c.n]   = static_cast<int32_t>(record.volumeID);
+                    c.int32Columns[kMaterialID][c.n] = static_cast<int32_t>(record.materialID);
+                    c.doubleColumns[kPreX - kPreX][c.n]       = record.pre[0];
+                    c.doubleColumns[kPreY - kPreX][c.n]       = record.pre[1];
+                    c.doubleColumns[kPreZ - kPreX][c.n]       = record.pre[2];
+                    c.doubleColumns[kPostX - kPreX][c.n]      = record.post[0];
+                    c.doubleColumns[kPostY - kPreX][c.n]      = record.post[1];
+                    c.doubleColumns[kPostZ - kPreX][c.n]      = record.post[2];
+                    c.doubleColumns[kStepLength - kPreX][c.n] = record.stepLength;
+
+                    if(++c.n == chunkSize_) this->Submit();
+                }
+
+                uint64_t GetNumberOfRecords() const {return nRecords_;}
+
+            private:
+                struct Chunk
+                {
+                    uint32_t n;
+                    std::vector<int32_t> int32Columns[kPreX];
+                    std::vector<double>  doubleColumns[kNumberOfColumns - kPreX];
+                };
+                typedef boost::shared_ptr<Chunk> ChunkPtr;
+
+            private:
+                void Submit();
+                void WriteLoop();
+                void WriteChunk(const Chunk& c);
+                void WriteDictionary(const Dictionary& d);
+                void Write(const void* data, size_t size);
+
+            private:
+                std::FILE* pFile_;
+                uint32_t   chunkSize_;
+                uint64_t   nRecords_;
+
+                ChunkPtr             pCurrent_;
+                std::deque<ChunkPtr> free_;
+                std::deque<ChunkPtr> full_;
+                bool                 stopping_;
+
+                boost::mutex              mutex_;
+                boost::condition_variable freeReady_;
+                boost::condition_variable fullReady_;
+                boost::thread             writer_;
+
+                //----- Owned by the writer thread until it is joined
+                std::vector<ChunkIndexEntry> index_;
+                uint64_t                     offset_;
+                bool                         failed_;
+        };
+
+    } // namespace steprecord
+} // namespace latte
+#endif // STEPRECORDWRITER_HH
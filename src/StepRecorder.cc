@@ -0,0 +1,95 @@
+#include "StepRecorder.hh"
+
+#include "G4Event.hh"
+#include "G4Step.hh"
+#include "G4Material.hh"
+#include "G4ios.hh"
+
+namespace latte {
+    namespace steprecord {
+
+        StepRecorder::StepRecorder() : latte::action::IUserActionObserver(),
+        writer_(), paths_(), chunkSize_(1<<16), eventID_(0)
+        {
+            //----- Default Constructor
+        }
+
+
+        StepRecorder::~StepRecorder()
+        {
+            //----- Destructor
+            this->Close();
+        }
+
+
+        G4bool StepRecorder::Open(const G4String& fileName)
+        {
+            if(writer_.IsOpen()) {
+                G4cerr<<"gdmlview: step record file already open, close it first"<<G4endl;
+                return false;
+            }
+
+            paths_.Clear();
+            if(!writer_.Open(fileName, static_cast<uint32_t>(chunkSize_))) {
+                G4cerr<<"gdmlview: cannot open step record file \""<<fileName<<"\""<<G4endl;
+                return false;
+            }
+            return true;
+        }
+
+
+        void StepRecorder::Close()
+        {
+            if(!writer_.IsOpen()) return;
+
+            //----- Material IDs are indices into the material table
+            StepRecordWriter::Dictionary materials;
+            const G4MaterialTable* table = G4Material::GetMaterialTable();
+            for(size_t i = 0; i < table->size(); ++i) {
+                materials.push_back((*table)[i]->GetName());
+            }
+
+            uint64_t nRecords = writer_.GetNumberOfRecords();
+            if(!writer_.Close(paths_.GetPaths(), materials)) {
+                G4cerr<<"gdmlview: error writing step records, the file is incomplete and unreadable"<<G4endl;
+                return;
+            }
+
+            G4cout<<"gdmlview: wrote "<<nRecords<<" step records in "
+                  <<paths_.GetPaths().size()<<" volumes"<<G4endl;
+        }
+
+
+        void StepRecorder::BeginOfEvent(const G4Event* anEvent)
+        {
+            eventID_ = anEvent->GetEventID();
+        }
+
+
+        void StepRecorder::Step(const G4Step* aStep)
+        {
+            if(!writer_.IsOpen()) return;
+
+            const G4StepPoint* pre = aStep->GetPreStepPoint();
+            const G4StepPoint* post = aStep->GetPostStepPoint();
+            const G4ThreeVector& a = pre->GetPosition();
+            const G4ThreeVector& b = post->GetPosition();
+
+            StepRecord r;
+            r.eventID    = eventID_;
+            r.trackID    = aStep->GetTrack()->GetTrackID();
+            r.volumeID   = paths_.GetID(pre->GetTouchableHandle()());
+            r.materialID = static_cast<uint32_t>(pre->GetMaterial()->GetIndex());
+            r.pre[0]  = a.x();
+            r.pre[1]  = a.y();
+            r.pre[2]  = a.z();
+            r.post[0] = b.x();
+            r.post[1] = b.y();
+            r.post[2] = b.z();
+            r.stepLength = aStep->GetStepLength();
+
+            writer_.Append(r);
+        }
+
+    } // namespace steprecord
+} // namespace latte
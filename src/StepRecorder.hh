@@ -0,0 +1,49 @@
+#ifndef STEPRECORDER_HH
+#define STEPRECORDER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User action observer writing every step to a columnar step
+//              record file (see StepRecordFormat.hh).
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "IUserActionObserver.hh"
+#include "StepRecordWriter.hh"
+#include "TouchablePathIndex.hh"
+
+#include "globals.hh"
+
+namespace latte {
+    namespace steprecord {
+
+        class StepRecorder : public latte::action::IUserActionObserver
+        {
+            public:
+                StepRecorder();
+                virtual ~StepRecorder();
+
+                //----- File control, Open fails if a file is already open
+                G4bool Open(const G4String& fileName);
+                void Close();
+                G4bool IsOpen() const {return writer_.IsOpen();}
+
+                void SetChunkSize(G4int n) {chunkSize_ = n > 0 ? n : 1;}
+
+                //----- Observer interface
+                void BeginOfEvent(const G4Event* anEvent);
+                void Step(const G4Step* aStep);
+
+            private:
+                StepRecordWriter                     writer_;
+                latte::geometry::TouchablePathIndex  paths_;
+                G4int                                chunkSize_;
+                G4int                                eventID_;
+        };
+
+    } // namespace steprecord
+} // namespace latte
+#endif // STEPRECORDER_HH
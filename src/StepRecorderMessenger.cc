@@ -0,0 +1,61 @@
+#include "StepRecorderMessenger.hh"
+
+#include "StepRecorder.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+namespace latte {
+    namespace steprecord {
+
+        StepRecorderMessenger::StepRecorderMessenger(StepRecorder* messengedObject) : G4UImessenger(),
+        pMessengedRecorder_(messengedObject), pDirectory_(0), pOpenCmd_(0), pCloseCmd_(0), pChunkSizeCmd_(0)
+        {
+            //----- Default Constructor
+            pDirectory_ = new G4UIdirectory("/gdmlview/steps/");
+            pDirectory_->SetGuidance("Binary, columnar recording of every transport step");
+
+            pOpenCmd_ = new G4UIcmdWithAString("/gdmlview/steps/open",this);
+            pOpenCmd_->SetGuidance("start recording steps to the given file");
+            pOpenCmd_->SetGuidance("the file is complete only after /gdmlview/steps/close or exit");
+            pOpenCmd_->SetParameterName("file", false);
+            pOpenCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pCloseCmd_ = new G4UIcmdWithoutParameter("/gdmlview/steps/close",this);
+            pCloseCmd_->SetGuidance("flush and close the step record file");
+            pCloseCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pChunkSizeCmd_ = new G4UIcmdWithAnInteger("/gdmlview/steps/chunkSize",this);
+            pChunkSizeCmd_->SetGuidance("number of steps per chunk, applies to the next file opened");
+            pChunkSizeCmd_->SetParameterName("n", false);
+            pChunkSizeCmd_->SetRange("n > 0");
+            pChunkSizeCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        StepRecorderMessenger::~StepRecorderMessenger()
+        {
+            //----- Destructor
+            delete pChunkSizeCmd_;
+            delete pCloseCmd_;
+            delete pOpenCmd_;
+            delete pDirectory_;
+        }
+
+
+        void StepRecorderMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pOpenCmd_) {
+                pMessengedRecorder_->Open(args);
+            }
+            else if ( cmd == pCloseCmd_) {
+                pMessengedRecorder_->Close();
+            }
+            else if ( cmd == pChunkSizeCmd_) {
+                pMessengedRecorder_->SetChunkSize(pChunkSizeCmd_->GetNewIntValue(args));
+            }
+        }
+
+    } // namespace steprecord
+} // namespace latte
@@ -0,0 +1,45 @@
+#ifndef STEPRECORDERMESSENGER_HH
+#define STEPRECORDERMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for StepRecorder
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+namespace latte {
+    namespace steprecord {
+
+        class StepRecorder;
+
+        class StepRecorderMessenger : public G4UImessenger
+        {
+            public:
+                StepRecorderMessenger(StepRecorder* messengedObject);
+                virtual ~StepRecorderMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                StepRecorder*            pMessengedRecorder_;
+
+                G4UIdirectory*           pDirectory_;
+                G4UIcmdWithAString*      pOpenCmd_;
+                G4UIcmdWithoutParameter* pCloseCmd_;
+                G4UIcmdWithAnInteger*    pChunkSizeCmd_;
+        };
+
+    } // namespace steprecord
+} // namespace latte
+#endif // STEPRECORDERMESSENGER_HH
@@ -0,0 +1,92 @@
+#include "ThreadOutputBuffer.hh"
+
+#include "globals.hh"
+
+namespace latte {
+
+    ThreadOutputBuffer::ThreadOutputBuffer() : cout_(G4cout), cerr_(G4cerr), released_(false)
+    {;}
+
+
+    ThreadOutputBuffer::~ThreadOutputBuffer()
+    {
+        this->Release();
+    }
+
+
+    void ThreadOutputBuffer::Capture()
+    {
+        cout_.Capture(boost::this_thread::get_id());
+        cerr_.Capture(boost::this_thread::get_id());
+    }
+
+
+    void ThreadOutputBuffer::Release()
+    {
+        if(released_) return;
+        released_ = true;
+
+        cout_.Restore();
+        cerr_.Restore();
+        G4cout<<cout_.Held()<<std::flush;
+        G4cerr<<cerr_.Held()<<std::flush;
+    }
+
+
+    ThreadOutputBuffer::Switch::Switch(std::ostream& stream) : std::streambuf(), stream_(stream), pOriginal_(0),
+    mutex_(), captured_(), held_()
+    {
+        //----- No put area, so every write reaches overflow/xsputn and
+        // is routed by thread
+        stream_.flush();
+        pOriginal_ = stream_.rdbuf(this);
+    }
+
+
+    void ThreadOutputBuffer::Switch::Capture(boost::thread::id id)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        captured_ = id;
+    }
+
+
+    void ThreadOutputBuffer::Switch::Restore()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        if(pOriginal_) stream_.rdbuf(pOriginal_);
+        pOriginal_ = 0;
+    }
+
+
+    std::streambuf* ThreadOutputBuffer::Switch::Target()
+    {
+        return boost::this_thread::get_id() == captured_ ? &held_ : pOriginal_;
+    }
+
+
+    ThreadOutputBuffer::Switch::int_type ThreadOutputBuffer::Switch::overflow(int_type c)
+    {
+        if(traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+        boost::mutex::scoped_lock lock(mutex_);
+        std::streambuf* target = this->Target();
+        return target ? target->sputc(traits_type::to_char_type(c)) : traits_type::eof();
+    }
+
+
+    std::streamsize ThreadOutputBuffer::Switch::xsputn(const char* s, std::streamsize n)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::streambuf* target = this->Target();
+        return target ? target->sputn(s, n) : 0;
+    }
+
+
+    int ThreadOutputBuffer::Switch::sync()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        std::streambuf* target = this->Target();
+        return target ? target->pubsync() : -1;
+    }
+
+} // namespace latte
@@ -0,0 +1,78 @@
+#ifndef THREADOUTPUTBUFFER_HH
+#define THREADOUTPUTBUFFER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Holds back G4cout and G4cerr output from one background
+//              thread while it lives, passing other threads' output on as
+//              before.
+//
+//              Geant4's output buffers are not thread safe, and a UI session
+//              such as Qt must only be written to from its own thread, so
+//              code run off the main thread (e.g. the GDML parser) writes
+//              here instead. Release() replays what it wrote, on the main
+//              thread, once it has finished.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <iosfwd>
+#include <sstream>
+#include <streambuf>
+
+namespace latte {
+
+    class ThreadOutputBuffer
+    {
+        public:
+            //----- Redirects G4cout and G4cerr until Release()
+            ThreadOutputBuffer();
+            ~ThreadOutputBuffer();
+
+            //----- Call from the thread whose output is to be held
+            void Capture();
+
+            //----- Restore G4cout and G4cerr and replay the held output.
+            // The capturing thread must have finished.
+            void Release();
+
+        private:
+            //----- Sends the capturing thread's output to a string, and
+            // everybody else's to the stream's original buffer
+            class Switch : public std::streambuf
+            {
+                public:
+                    Switch(std::ostream& stream);
+
+                    void Capture(boost::thread::id id);
+                    void Restore();
+                    std::string Held() const {return held_.str();}
+
+                protected:
+                    virtual int_type overflow(int_type c);
+                    virtual std::streamsize xsputn(const char* s, std::streamsize n);
+                    virtual int sync();
+
+                private:
+                    std::streambuf* Target();
+
+                private:
+                    std::ostream&     stream_;
+                    std::streambuf*   pOriginal_;
+                    boost::mutex      mutex_;
+                    boost::thread::id captured_;
+                    std::stringbuf    held_;
+            };
+
+        private:
+            Switch cout_;
+            Switch cerr_;
+            bool   released_;
+    };
+
+} // namespace latte
+#endif // THREADOUTPUTBUFFER_HH
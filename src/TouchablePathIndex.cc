@@ -0,0 +1,108 @@
+#include "TouchablePathIndex.hh"
+
+#include "G4VTouchable.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <sstream>
+
+namespace {
+    //----- 64 bit finalizer from MurmurHash3
+    inline uint64_t Mix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        TouchablePathIndex::TouchablePathIndex() : ids_(), paths_(), histories_()
+        {;}
+
+
+        TouchablePathIndex::~TouchablePathIndex()
+        {;}
+
+
+        uint32_t TouchablePathIndex::GetID(const G4VTouchable* touchable)
+        {
+            uint64_t h = Hash(touchable);
+
+            std::pair<HashToIDMap::const_iterator, HashToIDMap::const_iterator> range = ids_.equal_range(h);
+            for(HashToIDMap::const_iterator iter = range.first; iter != range.second; ++iter) {
+                if(Matches(histories_[iter->second], touchable)) return iter->second;
+            }
+
+            uint32_t id = static_cast<uint32_t>(paths_.size());
+            ids_.insert(HashToIDMap::value_type(h, id));
+            paths_.push_back(Path(touchable));
+            histories_.push_back(MakeHistory(touchable));
+            return id;
+        }
+
+
+        void TouchablePathIndex::Clear()
+        {
+            ids_.clear();
+            paths_.clear();
+            histories_.clear();
+        }
+
+
+        uint64_t TouchablePathIndex::Hash(const G4VTouchable* touchable)
+        {
+            uint64_t h = 0x9e3779b97f4a7c15ULL;
+            G4int depth = touchable->GetHistoryDepth();
+
+            for(G4int i = 0; i <= depth; ++i) {
+                uint64_t pv = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(touchable->GetVolume(i)));
+                uint64_t copy = static_cast<uint32_t>(touchable->GetReplicaNumber(i));
+                h = Mix(h ^ pv);
+                h = Mix(h ^ (copy + (static_cast<uint64_t>(i) << 32)));
+            }
+            return h;
+        }
+
+
+        std::string TouchablePathIndex::Path(const G4VTouchable* touchable)
+        {
+            //----- Outermost volume first
+            std::ostringstream path;
+            for(G4int i = touchable->GetHistoryDepth(); i >= 0; --i) {
+                path<<"/"<<touchable->GetVolume(i)->GetName()<<":"<<touchable->GetReplicaNumber(i);
+            }
+            return path.str();
+        }
+
+
+        bool TouchablePathIndex::Matches(const History& history, const G4VTouchable* touchable)
+        {
+            G4int depth = touchable->GetHistoryDepth();
+            if(history.size() != static_cast<size_t>(depth + 1)) return false;
+
+            for(G4int i = 0; i <= depth; ++i) {
+                if(history[i].first != touchable->GetVolume(i)) return false;
+                if(history[i].second != touchable->GetReplicaNumber(i)) return false;
+            }
+            return true;
+        }
+
+
+        TouchablePathIndex::History TouchablePathIndex::MakeHistory(const G4VTouchable* touchable)
+        {
+            G4int depth = touchable->GetHistoryDepth();
+            History history;
+            history.reserve(depth + 1);
+            for(G4int i = 0; i <= depth; ++i) {
+                history.push_back(History::value_type(touchable->GetVolume(i), touchable->GetReplicaNumber(i)));
+            }
+            return history;
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,66 @@
+#ifndef TOUCHABLEPATHINDEX_HH
+#define TOUCHABLEPATHINDEX_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Assigns dense integer IDs to touchable paths. Lookups hash
+//              the (volume, copy number) history so the path string is only
+//              built the first time a touchable is seen. The history itself
+//              is kept with each ID, so colliding hashes get their own IDs.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+
+#include <boost/unordered_map.hpp>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class G4VTouchable;
+class G4VPhysicalVolume;
+
+namespace latte {
+    namespace geometry {
+
+        class TouchablePathIndex
+        {
+            public:
+                typedef std::vector<std::string> PathList;
+
+            public:
+                TouchablePathIndex();
+                ~TouchablePathIndex();
+
+                //----- ID of the touchable's path, adding it if new
+                uint32_t GetID(const G4VTouchable* touchable);
+
+                //----- Path strings in ID order, "/World:0/Det:0/Cell:12"
+                const PathList& GetPaths() const {return paths_;}
+
+                void Clear();
+
+                static uint64_t Hash(const G4VTouchable* touchable);
+                static std::string Path(const G4VTouchable* touchable);
+
+            private:
+                //----- (volume, copy number) pairs, innermost first
+                typedef std::vector<std::pair<const G4VPhysicalVolume*, G4int> > History;
+
+                static bool Matches(const History& history, const G4VTouchable* touchable);
+                static History MakeHistory(const G4VTouchable* touchable);
+
+            private:
+                typedef boost::unordered_multimap<uint64_t, uint32_t> HashToIDMap;
+                HashToIDMap          ids_;
+                PathList             paths_;
+                std::vector<History> histories_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // TOUCHABLEPATHINDEX_HH
@@ -0,0 +1,120 @@
+#include "TrajectoryStore.hh"
+
+namespace latte {
+    namespace vis {
+
+        TrajectoryStore::TrajectoryStore() : budget_(64*1024*1024), decimation_(1), minSpacing_(0.),
+        points_(), headers_(), nEvicted_(0),
+        inTrack_(false), current_(), pending_(), lastKept_(), stepsSinceKept_(0)
+        {
+            //----- Default Constructor
+        }
+
+
+        TrajectoryStore::~TrajectoryStore()
+        {;}
+
+
+        void TrajectoryStore::SetMemoryBudget(size_t bytes)
+        {
+            budget_ = bytes;
+            this->Evict();
+        }
+
+
+        void TrajectoryStore::SetDecimation(G4int n)
+        {
+            decimation_ = n > 1 ? n : 1;
+        }
+
+
+        void TrajectoryStore::SetMinimumSpacing(G4double length)
+        {
+            minSpacing_ = length > 0. ? length : 0.;
+        }
+
+
+        void TrajectoryStore::BeginTrack(G4int eventID, G4int trackID, G4double charge, const G4ThreeVector& start)
+        {
+            current_.eventID = eventID;
+            current_.trackID = trackID;
+            current_.nPoints = 0;
+            current_.charge = charge < 0. ? -1 : (charge > 0. ? 1 : 0);
+
+            pending_.clear();
+            inTrack_ = true;
+            this->Keep(start);
+        }
+
+
+        void TrajectoryStore::AddPoint(const G4ThreeVector& p)
+        {
+            //----- Decimate on step count, then on spacing
+            if(!inTrack_) return;
+            if(++stepsSinceKept_ < decimation_) return;
+            if(minSpacing_ > 0. && (p - lastKept_).mag2() < minSpacing_*minSpacing_) return;
+
+            this->Keep(p);
+        }
+
+
+        void TrajectoryStore::EndTrack(const G4ThreeVector& end)
+        {
+            //----- Always close the polyline at the true end point, then
+            // move the pending points into the shared FIFO
+            if(!inTrack_) return;
+            if(stepsSinceKept_ > 0) this->Keep(end);
+
+            current_.nPoints = static_cast<unsigned int>(pending_.size());
+            points_.insert(points_.end(), pending_.begin(), pending_.end());
+            headers_.push_back(current_);
+
+            pending_.clear();
+            inTrack_ = false;
+            this->Evict();
+        }
+
+
+        void TrajectoryStore::Clear()
+        {
+            //----- Swap with empties to actually release deque blocks
+            PointList().swap(points_);
+            HeaderList().swap(headers_);
+            std::vector<Point>().swap(pending_);
+            nEvicted_ = 0;
+            inTrack_ = false;
+        }
+
+
+        size_t TrajectoryStore::GetMemoryUsage() const
+        {
+            return points_.size()*sizeof(Point) + headers_.size()*sizeof(Header) + pending_.capacity()*sizeof(Point);
+        }
+
+
+        void TrajectoryStore::Keep(const G4ThreeVector& p)
+        {
+            Point q;
+            q.x = static_cast<float>(p.x());
+            q.y = static_cast<float>(p.y());
+            q.z = static_cast<float>(p.z());
+            pending_.push_back(q);
+
+            lastKept_ = p;
+            stepsSinceKept_ = 0;
+        }
+
+
+        void TrajectoryStore::Evict()
+        {
+            //----- Drop oldest tracks until we are back under budget, but
+            // always keep the most recent one
+            while(headers_.size() > 1 && this->GetMemoryUsage() > budget_) {
+                points_.erase(points_.begin(), points_.begin() + headers_.front().nPoints);
+                headers_.pop_front();
+                ++nEvicted_;
+            }
+        }
+
+    } // namespace vis
+} // namespace latte
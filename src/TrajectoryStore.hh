@@ -0,0 +1,106 @@
+#ifndef TRAJECTORYSTORE_HH
+#define TRAJECTORYSTORE_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Compact, memory bounded store of trajectory polylines.
+//              Points are held as single precision floats in one FIFO
+//              shared by all tracks, and the oldest tracks are evicted
+//              once the memory budget is exceeded.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <deque>
+#include <vector>
+
+namespace latte {
+    namespace vis {
+
+        class TrajectoryStore
+        {
+            public:
+                //----- Position in mm, quantized to float
+                struct Point
+                {
+                    float x;
+                    float y;
+                    float z;
+                };
+
+                //----- Per-track bookkeeping. Points for each track are
+                // contiguous in the point FIFO, in the same order as the
+                // headers.
+                struct Header
+                {
+                    G4int         eventID;
+                    G4int         trackID;
+                    unsigned int  nPoints;
+                    signed char   charge;
+                };
+
+                typedef std::deque<Point>  PointList;
+                typedef std::deque<Header> HeaderList;
+
+            public:
+                TrajectoryStore();
+                ~TrajectoryStore();
+
+                //----- Configuration
+                void SetMemoryBudget(size_t bytes);
+                size_t GetMemoryBudget() const {return budget_;}
+
+                // Keep only every n-th step point (first and last are
+                // always kept)
+                void SetDecimation(G4int n);
+                G4int GetDecimation() const {return decimation_;}
+
+                // Drop points closer than this to the last kept point
+                void SetMinimumSpacing(G4double length);
+                G4double GetMinimumSpacing() const {return minSpacing_;}
+
+                //----- Filling, one track at a time
+                void BeginTrack(G4int eventID, G4int trackID, G4double charge, const G4ThreeVector& start);
+                void AddPoint(const G4ThreeVector& p);
+                void EndTrack(const G4ThreeVector& end);
+
+                void Clear();
+
+                //----- Access
+                const HeaderList& GetHeaders() const {return headers_;}
+                const PointList& GetPoints() const {return points_;}
+
+                size_t GetNumberOfTrajectories() const {return headers_.size();}
+                size_t GetNumberOfPoints() const {return points_.size();}
+                size_t GetNumberOfEvicted() const {return nEvicted_;}
+                size_t GetMemoryUsage() const;
+
+            private:
+                void Keep(const G4ThreeVector& p);
+                void Evict();
+
+            private:
+                size_t   budget_;
+                G4int    decimation_;
+                G4double minSpacing_;
+
+                PointList  points_;
+                HeaderList headers_;
+                size_t     nEvicted_;
+
+                //----- Track in progress
+                bool               inTrack_;
+                Header             current_;
+                std::vector<Point> pending_;
+                G4ThreeVector      lastKept_;
+                G4int              stepsSinceKept_;
+        };
+
+    } // namespace vis
+} // namespace latte
+#endif // TRAJECTORYSTORE_HH
@@ -0,0 +1,158 @@
+#include "TrajectoryStoreMessenger.hh"
+
+#include "TrajectoryStore.hh"
+#include "TrajectoryStoreRecorder.hh"
+#include "TrajectoryStoreModel.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UImanager.hh"
+#include "G4VisManager.hh"
+#include "G4Scene.hh"
+#include "G4ios.hh"
+
+namespace latte {
+    namespace vis {
+
+        TrajectoryStoreMessenger::TrajectoryStoreMessenger(TrajectoryStore* store, TrajectoryStoreRecorder* recorder) : G4UImessenger(),
+        pStore_(store), pRecorder_(recorder), pModel_(0),
+        pDirectory_(0), pEnableCmd_(0), pRefreshCmd_(0), pBudgetCmd_(0), pDecimateCmd_(0),
+        pSpacingCmd_(0), pClearCmd_(0), pDrawCmd_(0), pPrintCmd_(0)
+        {
+            //----- Default Constructor
+            pModel_ = new TrajectoryStoreModel(pStore_);
+
+            pDirectory_ = new G4UIdirectory("/gdmlview/trajectories/");
+            pDirectory_->SetGuidance("Compact, memory bounded trajectory storage and drawing");
+
+            pEnableCmd_ = new G4UIcmdWithABool("/gdmlview/trajectories/enable",this);
+            pEnableCmd_->SetGuidance("record trajectories into the compact store");
+            pEnableCmd_->SetParameterName("enable", true);
+            pEnableCmd_->SetDefaultValue(true);
+            pEnableCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pRefreshCmd_ = new G4UIcmdWithABool("/gdmlview/trajectories/refreshAtEndOfRun",this);
+            pRefreshCmd_->SetGuidance("rebuild the current viewer at the end of each run");
+            pRefreshCmd_->SetParameterName("refresh", true);
+            pRefreshCmd_->SetDefaultValue(true);
+            pRefreshCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pBudgetCmd_ = new G4UIcmdWithADouble("/gdmlview/trajectories/budget",this);
+            pBudgetCmd_->SetGuidance("memory budget for stored trajectories in MB");
+            pBudgetCmd_->SetGuidance("oldest trajectories are dropped once it is exceeded");
+            pBudgetCmd_->SetParameterName("megabytes", false);
+            pBudgetCmd_->SetRange("megabytes > 0");
+            pBudgetCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pDecimateCmd_ = new G4UIcmdWithAnInteger("/gdmlview/trajectories/decimate",this);
+            pDecimateCmd_->SetGuidance("keep only every n-th step point");
+            pDecimateCmd_->SetGuidance("first and last points of each track are always kept");
+            pDecimateCmd_->SetParameterName("n", false);
+            pDecimateCmd_->SetRange("n >= 1");
+            pDecimateCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pSpacingCmd_ = new G4UIcmdWithADoubleAndUnit("/gdmlview/trajectories/minSpacing",this);
+            pSpacingCmd_->SetGuidance("drop step points closer than this to the last kept point");
+            pSpacingCmd_->SetParameterName("length", false);
+            pSpacingCmd_->SetRange("length >= 0.");
+            pSpacingCmd_->SetDefaultUnit("mm");
+            pSpacingCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pClearCmd_ = new G4UIcmdWithoutParameter("/gdmlview/trajectories/clear",this);
+            pClearCmd_->SetGuidance("remove all stored trajectories");
+            pClearCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+            pDrawCmd_ = new G4UIcmdWithoutParameter("/gdmlview/trajectories/draw",this);
+            pDrawCmd_->SetGuidance("add the stored trajectories to the current scene");
+            pDrawCmd_->AvailableForStates(G4State_Idle);
+
+            pPrintCmd_ = new G4UIcmdWithoutParameter("/gdmlview/trajectories/print",this);
+            pPrintCmd_->SetGuidance("print trajectory store settings and memory use");
+            pPrintCmd_->AvailableForStates(G4State_PreInit, G4State_Idle);
+        }
+
+        TrajectoryStoreMessenger::~TrajectoryStoreMessenger()
+        {
+            //----- Destructor
+            // pModel_ is deliberately not deleted, the vis scene may still
+            // refer to it.
+            delete pPrintCmd_;
+            delete pDrawCmd_;
+            delete pClearCmd_;
+            delete pSpacingCmd_;
+            delete pDecimateCmd_;
+            delete pBudgetCmd_;
+            delete pRefreshCmd_;
+            delete pEnableCmd_;
+            delete pDirectory_;
+        }
+
+
+        void TrajectoryStoreMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pEnableCmd_) {
+                pRecorder_->SetEnabled(pEnableCmd_->GetNewBoolValue(args));
+            }
+            else if ( cmd == pRefreshCmd_) {
+                pRecorder_->SetRefreshAtEndOfRun(pRefreshCmd_->GetNewBoolValue(args));
+            }
+            else if ( cmd == pBudgetCmd_) {
+                pStore_->SetMemoryBudget(static_cast<size_t>(pBudgetCmd_->GetNewDoubleValue(args)*1024.*1024.));
+            }
+            else if ( cmd == pDecimateCmd_) {
+                pStore_->SetDecimation(pDecimateCmd_->GetNewIntValue(args));
+            }
+            else if ( cmd == pSpacingCmd_) {
+                pStore_->SetMinimumSpacing(pSpacingCmd_->GetNewDoubleValue(args));
+            }
+            else if ( cmd == pClearCmd_) {
+                pStore_->Clear();
+            }
+            else if ( cmd == pDrawCmd_) {
+                this->AddModelToScene();
+            }
+            else if ( cmd == pPrintCmd_) {
+                this->PrintStatus();
+            }
+        }
+
+
+        void TrajectoryStoreMessenger::AddModelToScene()
+        {
+            //----- The model is run-duration, so it is redrawn from the store
+            // whenever the viewer is rebuilt rather than kept per event
+            G4VisManager* pVisManager = G4VisManager::GetInstance();
+            G4Scene* pScene = pVisManager ? pVisManager->GetCurrentScene() : 0;
+
+            if(!pScene) {
+                G4cerr<<"gdmlview: no current scene, use /vis/scene/create first"<<G4endl;
+                return;
+            }
+
+            pScene->AddRunDurationModel(pModel_, false);
+
+            G4UImanager* uiMan = G4UImanager::GetUIpointer();
+            uiMan->ApplyCommand("/vis/scene/notifyHandlers");
+        }
+
+
+        void TrajectoryStoreMessenger::PrintStatus()
+        {
+            G4cout<<"gdmlview trajectory store:"<<G4endl
+                  <<"  recording       : "<<(pRecorder_->IsEnabled() ? "on" : "off")<<G4endl
+                  <<"  trajectories    : "<<pStore_->GetNumberOfTrajectories()<<G4endl
+                  <<"  points          : "<<pStore_->GetNumberOfPoints()<<G4endl
+                  <<"  evicted         : "<<pStore_->GetNumberOfEvicted()<<G4endl
+                  <<"  memory (MB)     : "<<pStore_->GetMemoryUsage()/(1024.*1024.)
+                  <<" / "<<pStore_->GetMemoryBudget()/(1024.*1024.)<<G4endl
+                  <<"  decimation      : "<<pStore_->GetDecimation()<<G4endl
+                  <<"  min spacing (mm): "<<pStore_->GetMinimumSpacing()<<G4endl;
+        }
+
+    } // namespace vis
+} // namespace latte
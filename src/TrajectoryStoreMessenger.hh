@@ -0,0 +1,60 @@
+#ifndef TRAJECTORYSTOREMESSENGER_HH
+#define TRAJECTORYSTOREMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User interface for the compact trajectory store
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+namespace latte {
+    namespace vis {
+
+        class TrajectoryStore;
+        class TrajectoryStoreRecorder;
+        class TrajectoryStoreModel;
+
+        class TrajectoryStoreMessenger : public G4UImessenger
+        {
+            public:
+                TrajectoryStoreMessenger(TrajectoryStore* store, TrajectoryStoreRecorder* recorder);
+                virtual ~TrajectoryStoreMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                void AddModelToScene();
+                void PrintStatus();
+
+            private:
+                TrajectoryStore*           pStore_;
+                TrajectoryStoreRecorder*   pRecorder_;
+                TrajectoryStoreModel*      pModel_;
+
+                G4UIdirectory*             pDirectory_;
+                G4UIcmdWithABool*          pEnableCmd_;
+                G4UIcmdWithABool*          pRefreshCmd_;
+                G4UIcmdWithADouble*        pBudgetCmd_;
+                G4UIcmdWithAnInteger*      pDecimateCmd_;
+                G4UIcmdWithADoubleAndUnit* pSpacingCmd_;
+                G4UIcmdWithoutParameter*   pClearCmd_;
+                G4UIcmdWithoutParameter*   pDrawCmd_;
+                G4UIcmdWithoutParameter*   pPrintCmd_;
+        };
+
+    } // namespace vis
+} // namespace latte
+#endif // TRAJECTORYSTOREMESSENGER_HH
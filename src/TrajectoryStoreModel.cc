@@ -0,0 +1,62 @@
+#include "TrajectoryStoreModel.hh"
+#include "TrajectoryStore.hh"
+
+#include "G4VGraphicsScene.hh"
+#include "G4Polyline.hh"
+#include "G4Colour.hh"
+
+namespace latte {
+    namespace vis {
+
+        TrajectoryStoreModel::TrajectoryStoreModel(const TrajectoryStore* store) : G4VModel(),
+        pStore_(store),
+        negativeAtts_(G4Colour::Red()), neutralAtts_(G4Colour::Green()), positiveAtts_(G4Colour::Blue())
+        {
+            //----- Default Constructor
+            fType = "TrajectoryStoreModel";
+            fGlobalTag = "gdmlview compact trajectories";
+            fGlobalDescription = fGlobalTag;
+        }
+
+
+        TrajectoryStoreModel::~TrajectoryStoreModel()
+        {;}
+
+
+        void TrajectoryStoreModel::DescribeYourselfTo(G4VGraphicsScene& sceneHandler)
+        {
+            //----- One polyline per stored track, reusing the buffer
+            const TrajectoryStore::HeaderList& headers = pStore_->GetHeaders();
+            const TrajectoryStore::PointList& points = pStore_->GetPoints();
+
+            G4Polyline line;
+            TrajectoryStore::PointList::const_iterator pIter = points.begin();
+
+            sceneHandler.BeginPrimitives(G4Transform3D());
+
+            for(TrajectoryStore::HeaderList::const_iterator hIter = headers.begin(); hIter != headers.end(); ++hIter) {
+                line.clear();
+                line.reserve(hIter->nPoints);
+
+                for(unsigned int i = 0; i < hIter->nPoints; ++i, ++pIter) {
+                    line.push_back(G4Point3D(pIter->x, pIter->y, pIter->z));
+                }
+
+                if(hIter->charge < 0) {
+                    line.SetVisAttributes(&negativeAtts_);
+                }
+                else if(hIter->charge > 0) {
+                    line.SetVisAttributes(&positiveAtts_);
+                }
+                else {
+                    line.SetVisAttributes(&neutralAtts_);
+                }
+
+                if(line.size() > 1) sceneHandler.AddPrimitive(line);
+            }
+
+            sceneHandler.EndPrimitives();
+        }
+
+    } // namespace vis
+} // namespace latte
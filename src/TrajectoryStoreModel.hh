@@ -0,0 +1,41 @@
+#ifndef TRAJECTORYSTOREMODEL_HH
+#define TRAJECTORYSTOREMODEL_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Vis model drawing the contents of a TrajectoryStore as
+//              polylines coloured by charge.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4VModel.hh"
+#include "G4VisAttributes.hh"
+
+namespace latte {
+    namespace vis {
+
+        class TrajectoryStore;
+
+        class TrajectoryStoreModel : public G4VModel
+        {
+            public:
+                TrajectoryStoreModel(const TrajectoryStore* store);
+                virtual ~TrajectoryStoreModel();
+
+                virtual void DescribeYourselfTo(G4VGraphicsScene& sceneHandler);
+
+            private:
+                const TrajectoryStore* pStore_;
+
+                //----- Polylines only keep a pointer to their attributes
+                G4VisAttributes negativeAtts_;
+                G4VisAttributes neutralAtts_;
+                G4VisAttributes positiveAtts_;
+        };
+
+    } // namespace vis
+} // namespace latte
+#endif // TRAJECTORYSTOREMODEL_HH
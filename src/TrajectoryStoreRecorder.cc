@@ -0,0 +1,59 @@
+#include "TrajectoryStoreRecorder.hh"
+#include "TrajectoryStore.hh"
+
+#include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4UImanager.hh"
+#include "G4VVisManager.hh"
+
+namespace latte {
+    namespace vis {
+
+        TrajectoryStoreRecorder::TrajectoryStoreRecorder(TrajectoryStore* store) : latte::action::IUserActionObserver(),
+        pStore_(store), enabled_(true), refresh_(true), eventID_(0)
+        {
+            //----- Default Constructor
+        }
+
+
+        TrajectoryStoreRecorder::~TrajectoryStoreRecorder()
+        {;}
+
+
+        void TrajectoryStoreRecorder::EndOfRun(const G4Run*)
+        {
+            if(enabled_ && refresh_ && G4VVisManager::GetConcreteInstance()) {
+                G4UImanager::GetUIpointer()->ApplyCommand("/vis/viewer/rebuild");
+            }
+        }
+
+
+        void TrajectoryStoreRecorder::BeginOfEvent(const G4Event* anEvent)
+        {
+            eventID_ = anEvent->GetEventID();
+        }
+
+
+        void TrajectoryStoreRecorder::PreTrack(const G4Track* aTrack)
+        {
+            if(!enabled_) return;
+            pStore_->BeginTrack(eventID_, aTrack->GetTrackID(), aTrack->GetDefinition()->GetPDGCharge(), aTrack->GetPosition());
+        }
+
+
+        void TrajectoryStoreRecorder::PostTrack(const G4Track* aTrack)
+        {
+            if(!enabled_) return;
+            pStore_->EndTrack(aTrack->GetPosition());
+        }
+
+
+        void TrajectoryStoreRecorder::Step(const G4Step* aStep)
+        {
+            if(!enabled_) return;
+            pStore_->AddPoint(aStep->GetPostStepPoint()->GetPosition());
+        }
+
+    } // namespace vis
+} // namespace latte
@@ -0,0 +1,51 @@
+#ifndef TRAJECTORYSTORERECORDER_HH
+#define TRAJECTORYSTORERECORDER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: User action observer filling a TrajectoryStore directly from
+//              tracks and steps, bypassing G4TrajectoryContainer.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "IUserActionObserver.hh"
+#include "globals.hh"
+
+namespace latte {
+    namespace vis {
+
+        class TrajectoryStore;
+
+        class TrajectoryStoreRecorder : public latte::action::IUserActionObserver
+        {
+            public:
+                TrajectoryStoreRecorder(TrajectoryStore* store);
+                virtual ~TrajectoryStoreRecorder();
+
+                void SetEnabled(G4bool enabled) {enabled_ = enabled;}
+                G4bool IsEnabled() const {return enabled_;}
+
+                // Rebuild the current viewer at end of run so the new
+                // tracks appear
+                void SetRefreshAtEndOfRun(G4bool refresh) {refresh_ = refresh;}
+
+                //----- Observer interface
+                void EndOfRun(const G4Run*);
+                void BeginOfEvent(const G4Event* anEvent);
+                void PreTrack(const G4Track* aTrack);
+                void PostTrack(const G4Track* aTrack);
+                void Step(const G4Step* aStep);
+
+            private:
+                TrajectoryStore* pStore_;
+                G4bool           enabled_;
+                G4bool           refresh_;
+                G4int            eventID_;
+        };
+
+    } // namespace vis
+} // namespace latte
+#endif // TRAJECTORYSTORERECORDER_HH
@@ -23,6 +23,11 @@ namespace latte {
                 return associations_.insert(IdToProductMap::value_type(id,creator)).second != 0;
             }
 
+            bool IsRegistered(const IdentifierType& id) const
+            {
+                return associations_.find(id) != associations_.end();
+            }
+
             AbstractProduct* CreateProduct(const IdentifierType& id, int argc, char** argv)
             {
                 IdToProductMap::iterator iter = associations_.find(id);
@@ -72,6 +77,9 @@ namespace latte {
 #ifdef G4UI_USE_WIN32
 #include "G4UIWin32.hh"
 #endif
+#ifndef G4UI_USE_WIN32
+#include "UISocketSession.hh"
+#endif
 
 namespace latte {
     UISessionFactory BuildUISessionFactory()
@@ -90,6 +98,9 @@ namespace latte {
 #ifdef G4UI_USE_WIN32
         f.Register("win32", UISessionCreator<G4UIWin32>);
 #endif
+#ifndef G4UI_USE_WIN32
+        f.Register("socket", UISessionCreator<UISocketSession>);
+#endif
 
         return f;
     }
@@ -0,0 +1,491 @@
+#include "UISocketSession.hh"
+
+#include "PosixIO.hh"
+
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4UnitsTable.hh"
+#include "G4Material.hh"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    //----- Most points one locate-bulk request may send
+    const size_t kMaxBulkPoints = 1 << 24;
+
+    //----- Longest line a client may send
+    const size_t kMaxLineLength = 1 << 16;
+
+    enum LineStatus {kLineRead, kLineClosed, kLineTooLong};
+
+    //----- Next newline terminated line from fd. Only newly read bytes
+    // are searched for the newline.
+    LineStatus ReadLine(int fd, std::string& buffer, std::string& line)
+    {
+        std::string::size_type searched = 0;
+        std::string::size_type eol;
+        while((eol = buffer.find('\n', searched)) == std::string::npos) {
+            if(buffer.size() > kMaxLineLength) return kLineTooLong;
+            searched = buffer.size();
+
+            char chunk[4096];
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if(n < 0 && errno == EINTR) continue;
+            if(n <= 0) return kLineClosed;
+            buffer.append(chunk, n);
+        }
+        if(eol > kMaxLineLength) return kLineTooLong;
+
+        line.assign(buffer, 0, eol);
+        buffer.erase(0, eol + 1);
+        if(!line.empty() && line[line.size()-1] == '\r') line.erase(line.size()-1);
+        return kLineRead;
+    }
+
+    bool Reply(int fd, G4int status, std::string output)
+    {
+        if(!output.empty() && output[output.size()-1] != '\n') output += '\n';
+        size_t nLines = 0;
+        for(std::string::const_iterator c = output.begin(); c != output.end(); ++c) {
+            if(*c == '\n') ++nLines;
+        }
+
+        std::ostringstream header;
+        header<<status<<" "<<nLines<<"\n";
+        return latte::io::WriteAll(fd, header.str() + output, true);
+    }
+}
+
+namespace latte {
+
+    std::string UISocketSession::socketPath_;
+
+    void UISocketSession::SetSocketPath(const std::string& path)
+    {
+        socketPath_ = path;
+    }
+
+
+    std::string UISocketSession::GetSocketPath()
+    {
+        //----- Explicit path, then environment, then per-user default
+        if(socketPath_ != "") return socketPath_;
+
+        const char* env = std::getenv("GDMLVIEW_SOCKET");
+        if(env && *env) return env;
+
+        std::ostringstream path;
+        path<<"/tmp/gdmlview-"<<getuid()<<".sock";
+        return path.str();
+    }
+
+
+    UISocketSession::UISocketSession(int, char**) : G4UIsession(), path_(GetSocketPath()), listenFd_(-1),
+    stopping_(false), queueMutex_(), queueCond_(), doneCond_(), queue_(), clientMutex_(), clientCond_(),
+    clients_(), geometryMutex_(), locator_(), pCapture_(0), mainThread_(boost::this_thread::get_id()),
+    acceptor_()
+    {
+        G4UImanager* UI = G4UImanager::GetUIpointer();
+        UI->SetSession(this);
+        UI->SetCoutDestination(this);
+    }
+
+
+    UISocketSession::~UISocketSession()
+    {
+        G4UImanager* UI = G4UImanager::GetUIpointer();
+        if(UI) UI->SetCoutDestination(0);
+    }
+
+
+    G4UIsession* UISocketSession::SessionStart()
+    {
+        if(!this->Listen()) return 0;
+
+        //----- Installed only now, as the geometry builder's output buffer
+        // is restored when it finishes
+        ClientOutput clientCout(G4cout, mainThread_);
+        ClientOutput clientCerr(G4cerr, mainThread_);
+        std::cout<<"gdmlview: serving on "<<path_<<std::endl;
+
+        acceptor_ = boost::thread(&UISocketSession::AcceptLoop, this);
+
+        //----- Apply queued commands until shutdown. Queries are locked
+        // out while a command runs, as it may change the geometry.
+        G4UImanager* UI = G4UImanager::GetUIpointer();
+        while(true) {
+            Request* r = 0;
+            {
+                boost::unique_lock<boost::mutex> lock(queueMutex_);
+                while(queue_.empty() && !stopping_) queueCond_.wait(lock);
+                if(queue_.empty()) break;
+                r = queue_.front();
+                queue_.pop_front();
+            }
+
+            {
+                boost::unique_lock<boost::shared_mutex> lock(geometryMutex_);
+                pCapture_ = &r->output;
+                r->status = UI->ApplyCommand(r->command);
+                pCapture_ = 0;
+                locator_.Invalidate();
+            }
+
+            {
+                boost::unique_lock<boost::mutex> lock(queueMutex_);
+                r->done = true;
+            }
+            doneCond_.notify_all();
+        }
+
+        acceptor_.join();
+
+        //----- Unblock connected clients and wait for them to go
+        {
+            boost::unique_lock<boost::mutex> lock(clientMutex_);
+            for(std::set<int>::const_iterator fd = clients_.begin(); fd != clients_.end(); ++fd) {
+                ::shutdown(*fd, SHUT_RDWR);
+            }
+            while(!clients_.empty()) clientCond_.wait(lock);
+        }
+
+        ::close(listenFd_);
+        ::unlink(path_.c_str());
+        listenFd_ = -1;
+        return 0;
+    }
+
+
+    void UISocketSession::PauseSessionStart(const G4String&)
+    {
+        //----- Nobody to prompt, so pauses (e.g. /control/pause) are
+        // ignored
+    }
+
+
+    G4int UISocketSession::ReceiveG4cout(const G4String& coutString)
+    {
+        //----- pCapture_ is only touched by the main thread
+        if(boost::this_thread::get_id() == mainThread_ && pCapture_) {
+            pCapture_->append(coutString);
+        }
+        else {
+            std::cout<<coutString<<std::flush;
+        }
+        return 0;
+    }
+
+
+    G4int UISocketSession::ReceiveG4cerr(const G4String& cerrString)
+    {
+        if(boost::this_thread::get_id() == mainThread_ && pCapture_) {
+            pCapture_->append(cerrString);
+        }
+        std::cerr<<cerrString<<std::flush;
+        return 0;
+    }
+
+
+    bool UISocketSession::Listen()
+    {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if(path_.size() >= sizeof(addr.sun_path)) {
+            std::cerr<<"gdmlview: socket path too long: "<<path_<<std::endl;
+            return false;
+        }
+        std::strcpy(addr.sun_path, path_.c_str());
+
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listenFd_ < 0) {
+            std::cerr<<"gdmlview: cannot create socket: "<<std::strerror(errno)<<std::endl;
+            return false;
+        }
+
+        //----- A stale socket from a crashed server would block the bind,
+        // but one that still accepts connections belongs to a live server
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(probe >= 0) {
+            int connected = ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            int error = errno;
+            ::close(probe);
+            if(connected == 0) {
+                std::cerr<<"gdmlview: another server is listening on "<<path_<<std::endl;
+                ::close(listenFd_);
+                listenFd_ = -1;
+                return false;
+            }
+            if(error == ECONNREFUSED) ::unlink(path_.c_str());
+        }
+
+        if(::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+           ::listen(listenFd_, 16) < 0) {
+            std::cerr<<"gdmlview: cannot listen on "<<path_<<": "<<std::strerror(errno)<<std::endl;
+            ::close(listenFd_);
+            listenFd_ = -1;
+            return false;
+        }
+        ::chmod(path_.c_str(), S_IRUSR | S_IWUSR);
+        return true;
+    }
+
+
+    void UISocketSession::AcceptLoop()
+    {
+        //----- Poll with a timeout so shutdown is noticed
+        while(true) {
+            {
+                boost::unique_lock<boost::mutex> lock(queueMutex_);
+                if(stopping_) return;
+            }
+
+            pollfd pfd;
+            pfd.fd = listenFd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if(::poll(&pfd, 1, 200) <= 0) continue;
+
+            int fd = ::accept(listenFd_, 0, 0);
+            if(fd < 0) continue;
+
+            {
+                boost::unique_lock<boost::mutex> lock(clientMutex_);
+                clients_.insert(fd);
+            }
+            boost::thread client(&UISocketSession::ServeClient, this, fd);
+            client.detach();
+        }
+    }
+
+
+    void UISocketSession::ServeClient(int fd)
+    {
+        std::string buffer;
+        std::string line;
+
+        LineStatus read;
+        while((read = ReadLine(fd, buffer, line)) == kLineRead) {
+            std::istringstream words(line);
+            std::string verb;
+            words>>verb;
+            if(verb == "") continue;
+
+            std::string output;
+            G4int status = fCommandSucceeded;
+
+            if(verb == "exit") {
+                break;
+            }
+            else if(verb == "shutdown") {
+                this->RequestShutdown();
+                Reply(fd, status, output);
+                break;
+            }
+            else if(verb == "locate") {
+                std::string rest;
+                std::getline(words, rest);
+                std::istringstream args(rest);
+                G4double x(0.0), y(0.0), z(0.0), scale(1.0);
+                std::string unit("mm");
+                args>>x>>y>>z;
+                if(!args) {
+                    status = fParameterUnreadable;
+                    output = "usage: locate x y z [unit]";
+                }
+                else {
+                    args>>unit;
+                    if(!ParseUnit(unit, scale)) {
+                        status = fParameterUnreadable;
+                        output = "unknown unit: " + unit;
+                    }
+                    else {
+                        std::vector<G4ThreeVector> points(1, G4ThreeVector(x, y, z)*scale);
+                        status = this->Locate(points, output);
+                    }
+                }
+            }
+            else if(verb == "locate-bulk") {
+                size_t n(0);
+                G4double scale(1.0);
+                std::string unit("mm");
+                words>>n;
+                if(words) words>>unit;
+
+                //----- The point lines that follow cannot be told apart
+                // from commands, so a refused request ends the connection
+                if(n > kMaxBulkPoints) {
+                    std::ostringstream message;
+                    message<<"at most "<<kMaxBulkPoints<<" points per request";
+                    Reply(fd, fParameterOutOfRange, message.str());
+                    break;
+                }
+                if(!ParseUnit(unit, scale)) {
+                    Reply(fd, fParameterUnreadable, "unknown unit: " + unit);
+                    break;
+                }
+
+                std::vector<G4ThreeVector> points;
+                points.reserve(n);
+                G4ThreeVector p;
+                bool ok = true;
+                for(size_t i = 0; i < n; ++i) {
+                    if((read = ReadLine(fd, buffer, line)) != kLineRead) {
+                        ok = false;
+                        break;
+                    }
+                    if(!ParsePoint(line, scale, p)) {
+                        status = fParameterUnreadable;
+                        output = "unreadable point: " + line;
+                    }
+                    points.push_back(p);
+                }
+                if(!ok) break;
+                if(status == fCommandSucceeded) status = this->Locate(points, output);
+            }
+            else {
+                status = this->Execute(line, output);
+            }
+
+            if(!Reply(fd, status, output)) break;
+        }
+
+        //----- Whatever follows an overlong line cannot be trusted to
+        // start a new one
+        if(read == kLineTooLong) {
+            std::ostringstream message;
+            message<<"line longer than "<<kMaxLineLength<<" bytes";
+            Reply(fd, fParameterOutOfRange, message.str());
+        }
+
+        ::close(fd);
+        {
+            boost::unique_lock<boost::mutex> lock(clientMutex_);
+            clients_.erase(fd);
+        }
+        clientCond_.notify_all();
+    }
+
+
+    G4int UISocketSession::Execute(const std::string& command, std::string& output)
+    {
+        Request r(command);
+        {
+            boost::unique_lock<boost::mutex> lock(queueMutex_);
+            if(stopping_) {
+                output = "session is shutting down";
+                return fCommandNotFound;
+            }
+            queue_.push_back(&r);
+        }
+        queueCond_.notify_one();
+
+        boost::unique_lock<boost::mutex> lock(queueMutex_);
+        while(!r.done) doneCond_.wait(lock);
+        output = r.output;
+        return r.status;
+    }
+
+
+    void UISocketSession::RequestShutdown()
+    {
+        {
+            boost::unique_lock<boost::mutex> lock(queueMutex_);
+            stopping_ = true;
+        }
+        queueCond_.notify_all();
+    }
+
+
+    G4int UISocketSession::Locate(const std::vector<G4ThreeVector>& points, std::string& output)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(geometryMutex_);
+
+        latte::geometry::PointLocator::Location loc;
+        std::ostringstream out;
+        for(std::vector<G4ThreeVector>::const_iterator p = points.begin(); p != points.end(); ++p) {
+            locator_.Locate(*p, loc);
+            if(!loc.IsValid()) {
+                out<<"- -\n";
+                continue;
+            }
+            out<<latte::geometry::PointLocator::Path(loc)<<" "<<(loc.material ? loc.material->GetName() : G4String("-"))<<"\n";
+        }
+        output = out.str();
+        return fCommandSucceeded;
+    }
+
+
+    UISocketSession::ClientOutput::ClientOutput(std::ostream& stream, boost::thread::id mainThread) : std::streambuf(),
+    stream_(stream), pOriginal_(0), mainThread_(mainThread), mutex_()
+    {
+        //----- No put area, so every write reaches overflow/xsputn
+        stream_.flush();
+        pOriginal_ = stream_.rdbuf(this);
+    }
+
+
+    UISocketSession::ClientOutput::~ClientOutput()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        stream_.rdbuf(pOriginal_);
+    }
+
+
+    std::streambuf* UISocketSession::ClientOutput::Target()
+    {
+        return boost::this_thread::get_id() == mainThread_ ? pOriginal_ : std::cerr.rdbuf();
+    }
+
+
+    UISocketSession::ClientOutput::int_type UISocketSession::ClientOutput::overflow(int_type c)
+    {
+        if(traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+
+        boost::mutex::scoped_lock lock(mutex_);
+        return this->Target()->sputc(traits_type::to_char_type(c));
+    }
+
+
+    std::streamsize UISocketSession::ClientOutput::xsputn(const char* s, std::streamsize n)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        return this->Target()->sputn(s, n);
+    }
+
+
+    int UISocketSession::ClientOutput::sync()
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        return this->Target()->pubsync();
+    }
+
+
+    bool UISocketSession::ParsePoint(const std::string& line, G4double unit, G4ThreeVector& p)
+    {
+        std::istringstream in(line);
+        G4double x(0.0), y(0.0), z(0.0);
+        in>>x>>y>>z;
+        if(!in) return false;
+        p.set(x*unit, y*unit, z*unit);
+        return true;
+    }
+
+
+    bool UISocketSession::ParseUnit(const std::string& unit, G4double& value)
+    {
+        value = G4UnitDefinition::GetValueOf(unit);
+        return value > 0.0;
+    }
+
+} // namespace latte
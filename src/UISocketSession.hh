@@ -0,0 +1,148 @@
+#ifndef UISOCKETSESSION_HH
+#define UISOCKETSESSION_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: UI session serving a UNIX domain socket, so a single gdmlview
+//              process can keep a large geometry resident and answer
+//              commands from scripts and other tools.
+//
+//              Requests are newline terminated. Anything not listed below is
+//              applied as a UI command on the main thread, one at a time:
+//
+//                locate x y z [unit]     volume path and material at a point
+//                locate-bulk n [unit]    followed by n lines of "x y z"
+//                                        (n at most 2^24)
+//                exit                    close this connection
+//                shutdown                end the session
+//
+//              locate queries only read the geometry, so they run on the
+//              connection's own thread, in parallel with other queries, and
+//              are only held back while a UI command is being applied.
+//
+//              Each reply is a line "<status> <nlines>" followed by nlines
+//              lines of output. Status is the G4UImanager command status, 0
+//              on success.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "PointLocator.hh"
+
+#include "G4UIsession.hh"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <deque>
+#include <iosfwd>
+#include <set>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace latte {
+
+    class UISocketSession : public G4UIsession
+    {
+        public:
+            UISocketSession(int argc, char** argv);
+            virtual ~UISocketSession();
+
+            //----- Must be called before the session is created to
+            // override the default path
+            static void SetSocketPath(const std::string& path);
+            static std::string GetSocketPath();
+
+            virtual G4UIsession* SessionStart();
+            virtual void PauseSessionStart(const G4String& msg);
+
+            virtual G4int ReceiveG4cout(const G4String& coutString);
+            virtual G4int ReceiveG4cerr(const G4String& cerrString);
+
+        private:
+            struct Request
+            {
+                Request(const std::string& cmd) : command(cmd), status(0), output(), done(false) {;}
+
+                std::string command;
+                G4int       status;
+                std::string output;
+                bool        done;
+            };
+
+            //----- While it lives, passes the main thread's output on as
+            // before and sends every other thread's to std::cerr, one write
+            // at a time. Geant4's output buffers and the command capture are
+            // not thread safe, but queries may still warn, e.g. from the
+            // navigator.
+            class ClientOutput : public std::streambuf
+            {
+                public:
+                    ClientOutput(std::ostream& stream, boost::thread::id mainThread);
+                    virtual ~ClientOutput();
+
+                protected:
+                    virtual int_type overflow(int_type c);
+                    virtual std::streamsize xsputn(const char* s, std::streamsize n);
+                    virtual int sync();
+
+                private:
+                    std::streambuf* Target();
+
+                private:
+                    std::ostream&     stream_;
+                    std::streambuf*   pOriginal_;
+                    boost::thread::id mainThread_;
+                    boost::mutex      mutex_;
+            };
+
+        private:
+            bool Listen();
+            void AcceptLoop();
+            void ServeClient(int fd);
+
+            //----- Queue command for the main thread and wait for its result
+            G4int Execute(const std::string& command, std::string& output);
+            void RequestShutdown();
+
+            //----- Read-only queries, run on the client thread
+            G4int Locate(const std::vector<G4ThreeVector>& points, std::string& output);
+            static bool ParsePoint(const std::string& line, G4double unit, G4ThreeVector& p);
+            static bool ParseUnit(const std::string& unit, G4double& value);
+
+        private:
+            static std::string socketPath_;
+
+            std::string path_;
+            int listenFd_;
+            bool stopping_;
+
+            //----- Main thread command queue
+            boost::mutex queueMutex_;
+            boost::condition_variable queueCond_;
+            boost::condition_variable doneCond_;
+            std::deque<Request*> queue_;
+
+            //----- Connected clients, so shutdown can unblock them
+            boost::mutex clientMutex_;
+            boost::condition_variable clientCond_;
+            std::set<int> clients_;
+
+            //----- Exclusive for UI commands, shared for queries
+            boost::shared_mutex geometryMutex_;
+            latte::geometry::PointLocator locator_;
+
+            //----- Output of the command being applied, main thread only
+            std::string* pCapture_;
+            boost::thread::id mainThread_;
+
+            boost::thread acceptor_;
+    };
+
+} // namespace latte
+#endif // UISOCKETSESSION_HH
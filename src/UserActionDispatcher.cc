@@ -0,0 +1,127 @@
+#include "UserActionDispatcher.hh"
+#include "IUserActionObserver.hh"
+
+#include "G4RunManager.hh"
+#include "G4UserRunAction.hh"
+#include "G4UserEventAction.hh"
+#include "G4UserTrackingAction.hh"
+#include "G4UserSteppingAction.hh"
+
+#include <algorithm>
+
+namespace {
+    using latte::action::IUserActionObserver;
+    typedef latte::action::UserActionDispatcher::ObserverList ObserverList;
+
+    //----- Thin adaptors from each Geant4 action type to the observer list.
+    // They hold a reference to the dispatcher's list so observers attached
+    // after Install() still receive callbacks.
+    class DispatchRunAction : public G4UserRunAction
+    {
+        public:
+            DispatchRunAction(const ObserverList& obs) : G4UserRunAction(), obs_(obs) {;}
+
+            void BeginOfRunAction(const G4Run* aRun)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->BeginOfRun(aRun);
+            }
+
+            void EndOfRunAction(const G4Run* aRun)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->EndOfRun(aRun);
+            }
+
+        private:
+            const ObserverList& obs_;
+    };
+
+    class DispatchEventAction : public G4UserEventAction
+    {
+        public:
+            DispatchEventAction(const ObserverList& obs) : G4UserEventAction(), obs_(obs) {;}
+
+            void BeginOfEventAction(const G4Event* anEvent)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->BeginOfEvent(anEvent);
+            }
+
+            void EndOfEventAction(const G4Event* anEvent)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->EndOfEvent(anEvent);
+            }
+
+        private:
+            const ObserverList& obs_;
+    };
+
+    class DispatchTrackingAction : public G4UserTrackingAction
+    {
+        public:
+            DispatchTrackingAction(const ObserverList& obs) : G4UserTrackingAction(), obs_(obs) {;}
+
+            void PreUserTrackingAction(const G4Track* aTrack)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->PreTrack(aTrack);
+            }
+
+            void PostUserTrackingAction(const G4Track* aTrack)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->PostTrack(aTrack);
+            }
+
+        private:
+            const ObserverList& obs_;
+    };
+
+    class DispatchSteppingAction : public G4UserSteppingAction
+    {
+        public:
+            DispatchSteppingAction(const ObserverList& obs) : G4UserSteppingAction(), obs_(obs) {;}
+
+            void UserSteppingAction(const G4Step* aStep)
+            {
+                for(size_t i = 0; i < obs_.size(); ++i) obs_[i]->Step(aStep);
+            }
+
+        private:
+            const ObserverList& obs_;
+    };
+}
+
+namespace latte {
+    namespace action {
+
+        UserActionDispatcher::UserActionDispatcher() : observers_()
+        {;}
+
+
+        UserActionDispatcher::~UserActionDispatcher()
+        {;}
+
+
+        void UserActionDispatcher::Attach(IUserActionObserver* observer)
+        {
+            //----- Ignore nulls and duplicates
+            if(!observer) return;
+            if(std::find(observers_.begin(), observers_.end(), observer) == observers_.end()) {
+                observers_.push_back(observer);
+            }
+        }
+
+
+        void UserActionDispatcher::Detach(IUserActionObserver* observer)
+        {
+            observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+        }
+
+
+        void UserActionDispatcher::Install(G4RunManager* rm)
+        {
+            rm->SetUserAction(new DispatchRunAction(observers_));
+            rm->SetUserAction(new DispatchEventAction(observers_));
+            rm->SetUserAction(new DispatchTrackingAction(observers_));
+            rm->SetUserAction(new DispatchSteppingAction(observers_));
+        }
+
+    } // namespace action
+} // namespace latte
@@ -0,0 +1,49 @@
+#ifndef USERACTIONDISPATCHER_HH
+#define USERACTIONDISPATCHER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Fans the single set of Geant4 user actions out to any number
+//              of IUserActionObservers.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include <vector>
+
+class G4RunManager;
+
+namespace latte {
+    namespace action {
+
+        class IUserActionObserver;
+
+        class UserActionDispatcher
+        {
+            public:
+                typedef std::vector<IUserActionObserver*> ObserverList;
+
+            public:
+                UserActionDispatcher();
+                ~UserActionDispatcher();
+
+                //----- Observers are not owned, and are called in the
+                // order they were attached
+                void Attach(IUserActionObserver* observer);
+                void Detach(IUserActionObserver* observer);
+
+                //----- Register run/event/tracking/stepping actions with
+                // the run manager, which takes ownership of them.
+                void Install(G4RunManager* rm);
+
+                const ObserverList& GetObservers() const {return observers_;}
+
+            private:
+                ObserverList observers_;
+        };
+
+    } // namespace action
+} // namespace latte
+#endif // USERACTIONDISPATCHER_HH
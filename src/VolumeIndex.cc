@@ -0,0 +1,402 @@
+#include "VolumeIndex.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <fnmatch.h>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    //----- Split "name:copy", copy is empty if absent
+    void SplitComponent(const std::string& component, std::string& name, std::string& copy)
+    {
+        std::string::size_type colon = component.rfind(':');
+        if(colon == std::string::npos) {
+            name = component;
+            copy = "";
+            return;
+        }
+        name = component.substr(0, colon);
+        copy = component.substr(colon + 1);
+    }
+
+    bool ParseCopy(const std::string& copy, G4int& value)
+    {
+        if(copy.empty()) return false;
+        char* end = 0;
+        long v = std::strtol(copy.c_str(), &end, 10);
+        if(*end != '\0') return false;
+        value = static_cast<G4int>(v);
+        return true;
+    }
+
+    std::vector<std::string> SplitPath(const std::string& path)
+    {
+        std::vector<std::string> components;
+        std::istringstream in(path);
+        std::string c;
+        while(std::getline(in, c, '/')) {
+            if(!c.empty()) components.push_back(c);
+        }
+        return components;
+    }
+
+    bool IsGlob(const std::string& s)
+    {
+        return s.find_first_of("*?[") != std::string::npos;
+    }
+
+    bool Matches(const std::string& pattern, const std::string& s)
+    {
+        return fnmatch(pattern.c_str(), s.c_str(), 0) == 0;
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        const G4int VolumeIndex::kAnyCopy = INT_MIN;
+        const G4int VolumeIndex::kReplicated = INT_MIN + 1;
+
+        VolumeIndex::VolumeIndex() : pWorld_(0), nameIDs_(), names_(), placements_(), namedPlacements_(), mothers_(), firstPlacements_()
+        {;}
+
+
+        VolumeIndex::~VolumeIndex()
+        {;}
+
+
+        void VolumeIndex::Clear()
+        {
+            pWorld_ = 0;
+            nameIDs_.clear();
+            names_.clear();
+            placements_.clear();
+            namedPlacements_.clear();
+            mothers_.clear();
+            firstPlacements_.clear();
+        }
+
+
+        void VolumeIndex::Build(G4VPhysicalVolume* world)
+        {
+            this->Clear();
+            if(!world) return;
+            pWorld_ = world;
+
+            //----- Logical volumes by name, including those not placed
+            G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+            for(G4LogicalVolumeStore::const_iterator iter = lvStore->begin(); iter != lvStore->end(); ++iter) {
+                names_[this->Intern((*iter)->GetName())].logicals.push_back(*iter);
+            }
+
+            //----- Walk each logical volume once, so shared subtrees are
+            // indexed once however often they are placed
+            names_[this->Intern(world->GetName())].physicals.push_back(world);
+            G4LogicalVolume* worldLogical = world->GetLogicalVolume();
+            firstPlacements_[worldLogical] = world;
+
+            std::vector<G4LogicalVolume*> stack(1, worldLogical);
+            while(!stack.empty()) {
+                G4LogicalVolume* mother = stack.back();
+                stack.pop_back();
+
+                for(G4int i = 0; i < mother->GetNoDaughters(); ++i) {
+                    G4VPhysicalVolume* pv = mother->GetDaughter(i);
+                    uint32_t id = this->Intern(pv->GetName());
+                    names_[id].physicals.push_back(pv);
+                    mothers_[pv] = mother;
+
+                    G4int copy = pv->IsReplicated() ? kReplicated : pv->GetCopyNo();
+                    placements_[PlacementKey(mother, id, copy)] = pv;
+                    namedPlacements_[PlacementKey(mother, id, kAnyCopy)].push_back(pv);
+
+                    G4LogicalVolume* daughter = pv->GetLogicalVolume();
+                    if(firstPlacements_.insert(FirstPlacementMap::value_type(daughter, pv)).second) {
+                        stack.push_back(daughter);
+                    }
+                }
+            }
+        }
+
+
+        const VolumeIndex::LogicalList& VolumeIndex::FindLogical(const std::string& name) const
+        {
+            static const LogicalList none;
+            const NameEntry* entry = this->Lookup(name);
+            return entry ? entry->logicals : none;
+        }
+
+
+        const VolumeIndex::PhysicalList& VolumeIndex::FindPhysical(const std::string& name) const
+        {
+            static const PhysicalList none;
+            const NameEntry* entry = this->Lookup(name);
+            return entry ? entry->physicals : none;
+        }
+
+
+        G4bool VolumeIndex::Resolve(const std::string& path, Path& out) const
+        {
+            out.clear();
+            if(!pWorld_) return false;
+
+            //----- "/" alone is the world
+            std::vector<std::string> components = SplitPath(path);
+            if(components.empty()) {
+                out.push_back(std::make_pair(pWorld_, pWorld_->GetCopyNo()));
+                return true;
+            }
+
+            std::string name, copyString;
+            SplitComponent(components[0], name, copyString);
+            G4int copy(0);
+            if(name != pWorld_->GetName()) return false;
+            if(copyString != "" && (!ParseCopy(copyString, copy) || copy != pWorld_->GetCopyNo())) return false;
+            out.push_back(std::make_pair(pWorld_, pWorld_->GetCopyNo()));
+
+            for(size_t level = 1; level < components.size(); ++level) {
+                SplitComponent(components[level], name, copyString);
+                if(copyString == "") {
+                    copy = kAnyCopy;
+                }
+                else if(!ParseCopy(copyString, copy)) {
+                    //----- Not a copy number, so part of the name
+                    name = components[level];
+                    copy = kAnyCopy;
+                }
+
+                G4VPhysicalVolume* pv = this->Daughter(out.back().first->GetLogicalVolume(), name, copy);
+                if(!pv) {
+                    out.clear();
+                    return false;
+                }
+                out.push_back(std::make_pair(pv, copy));
+            }
+            return true;
+        }
+
+
+        G4bool VolumeIndex::ResolveNameOrPath(const std::string& nameOrPath, Path& out) const
+        {
+            if(!nameOrPath.empty() && nameOrPath[0] == '/') return this->Resolve(nameOrPath, out);
+
+            const PhysicalList& pvs = this->FindPhysical(nameOrPath);
+            if(pvs.empty()) {
+                out.clear();
+                return false;
+            }
+            return this->PathTo(pvs.front(), out);
+        }
+
+
+        G4bool VolumeIndex::PathTo(G4VPhysicalVolume* pv, Path& out) const
+        {
+            out.clear();
+            if(!pWorld_) return false;
+
+            //----- Climb through the first placement of each mother
+            while(pv != pWorld_) {
+                out.push_back(std::make_pair(pv, CopyNumber(pv)));
+
+                MotherMap::const_iterator mother = mothers_.find(pv);
+                if(mother == mothers_.end()) {
+                    out.clear();
+                    return false;
+                }
+                pv = firstPlacements_.find(mother->second)->second;
+            }
+            out.push_back(std::make_pair(pWorld_, pWorld_->GetCopyNo()));
+
+            std::reverse(out.begin(), out.end());
+            return true;
+        }
+
+
+        size_t VolumeIndex::Find(const std::string& glob, std::vector<std::string>& matches, size_t max) const
+        {
+            size_t nStart = matches.size();
+            if(!pWorld_) return 0;
+
+            //----- Path globs walk the placement tree level by level
+            if(!glob.empty() && glob[0] == '/') {
+                std::vector<std::string> patterns = SplitPath(glob);
+                if(patterns.empty()) return 0;
+
+                std::string name, copy;
+                SplitComponent(patterns[0], name, copy);
+                if(!Matches(name, pWorld_->GetName())) return 0;
+
+                Path current(1, std::make_pair(pWorld_, pWorld_->GetCopyNo()));
+                this->FindPaths(pWorld_->GetLogicalVolume(), patterns, 1, current, matches, nStart + max);
+                return matches.size() - nStart;
+            }
+
+            //----- Name globs scan the interned names, plain names hash
+            std::vector<const NameEntry*> entries;
+            if(IsGlob(glob)) {
+                for(std::vector<NameEntry>::const_iterator entry = names_.begin(); entry != names_.end(); ++entry) {
+                    if(Matches(glob, entry->name)) entries.push_back(&(*entry));
+                }
+            }
+            else if(const NameEntry* entry = this->Lookup(glob)) {
+                entries.push_back(entry);
+            }
+
+            Path path;
+            for(std::vector<const NameEntry*>::const_iterator entry = entries.begin(); entry != entries.end(); ++entry) {
+                for(LogicalList::const_iterator lv = (*entry)->logicals.begin(); lv != (*entry)->logicals.end(); ++lv) {
+                    if(matches.size() - nStart >= max) return max;
+                    matches.push_back("logical  " + (*lv)->GetName());
+                }
+                for(PhysicalList::const_iterator pv = (*entry)->physicals.begin(); pv != (*entry)->physicals.end(); ++pv) {
+                    if(matches.size() - nStart >= max) return max;
+                    if(this->PathTo(*pv, path)) matches.push_back("physical " + ToString(path));
+                }
+            }
+            return matches.size() - nStart;
+        }
+
+
+        std::string VolumeIndex::ToString(const Path& path)
+        {
+            std::ostringstream s;
+            for(Path::const_iterator level = path.begin(); level != path.end(); ++level) {
+                s<<"/"<<level->first->GetName()<<":"<<level->second;
+            }
+            return s.str();
+        }
+
+
+        uint32_t VolumeIndex::Intern(const std::string& name)
+        {
+            std::pair<NameToIDMap::iterator, bool> result =
+                nameIDs_.insert(NameToIDMap::value_type(name, static_cast<uint32_t>(names_.size())));
+            if(result.second) {
+                names_.push_back(NameEntry());
+                names_.back().name = name;
+            }
+            return result.first->second;
+        }
+
+
+        const VolumeIndex::NameEntry* VolumeIndex::Lookup(const std::string& name) const
+        {
+            NameToIDMap::const_iterator id = nameIDs_.find(name);
+            return id == nameIDs_.end() ? 0 : &names_[id->second];
+        }
+
+
+        G4VPhysicalVolume* VolumeIndex::Daughter(const G4LogicalVolume* mother, const std::string& name, G4int& copy) const
+        {
+            NameToIDMap::const_iterator id = nameIDs_.find(name);
+            if(id == nameIDs_.end()) return 0;
+
+            if(copy == kAnyCopy) {
+                NamedPlacementMap::const_iterator named = namedPlacements_.find(PlacementKey(mother, id->second, kAnyCopy));
+                if(named == namedPlacements_.end()) return 0;
+                copy = CopyNumber(named->second.front());
+                return named->second.front();
+            }
+
+            PlacementMap::const_iterator pv = placements_.find(PlacementKey(mother, id->second, copy));
+            if(pv != placements_.end()) return pv->second;
+
+            //----- One replicated volume stands for all its copies
+            pv = placements_.find(PlacementKey(mother, id->second, kReplicated));
+            if(pv != placements_.end() && copy >= 0 && copy < pv->second->GetMultiplicity()) return pv->second;
+            return 0;
+        }
+
+
+        void VolumeIndex::FindPaths(const G4LogicalVolume* mother, const std::vector<std::string>& patterns,
+                size_t level, Path& current, std::vector<std::string>& matches, size_t max) const
+        {
+            if(level == patterns.size()) {
+                matches.push_back(ToString(current));
+                return;
+            }
+
+            std::string namePattern, copyPattern;
+            SplitComponent(patterns[level], namePattern, copyPattern);
+
+            G4int copy(0);
+            G4bool isCopyLiteral = copyPattern != "" && !IsGlob(copyPattern);
+            if(isCopyLiteral && !ParseCopy(copyPattern, copy)) {
+                //----- Not a copy number, so part of the name, as in Resolve
+                namePattern = patterns[level];
+                copyPattern = "";
+                isCopyLiteral = false;
+            }
+            G4bool isNameLiteral = !IsGlob(namePattern);
+
+            //----- A literal name and copy number is one hash lookup, with no
+            // expansion of replicas
+            if(isNameLiteral && isCopyLiteral) {
+                G4VPhysicalVolume* pv = this->Daughter(mother, namePattern, copy);
+                if(pv) {
+                    current.push_back(std::make_pair(pv, copy));
+                    this->FindPaths(pv->GetLogicalVolume(), patterns, level + 1, current, matches, max);
+                    current.pop_back();
+                }
+                return;
+            }
+
+            //----- Literal names hash to their placements, only globs are
+            // matched against every daughter
+            const PhysicalList* named = 0;
+            if(isNameLiteral) {
+                NameToIDMap::const_iterator id = nameIDs_.find(namePattern);
+                if(id == nameIDs_.end()) return;
+                NamedPlacementMap::const_iterator entry = namedPlacements_.find(PlacementKey(mother, id->second, kAnyCopy));
+                if(entry == namedPlacements_.end()) return;
+                named = &entry->second;
+            }
+
+            G4int nCandidates = named ? static_cast<G4int>(named->size()) : mother->GetNoDaughters();
+            for(G4int i = 0; i < nCandidates && matches.size() < max; ++i) {
+                G4VPhysicalVolume* pv = named ? (*named)[i] : mother->GetDaughter(i);
+                if(!named && !Matches(namePattern, pv->GetName())) continue;
+
+                if(isCopyLiteral) {
+                    G4bool hasCopy = pv->IsReplicated() ? copy >= 0 && copy < pv->GetMultiplicity() : copy == pv->GetCopyNo();
+                    if(!hasCopy) continue;
+                    current.push_back(std::make_pair(pv, copy));
+                    this->FindPaths(pv->GetLogicalVolume(), patterns, level + 1, current, matches, max);
+                    current.pop_back();
+                    continue;
+                }
+
+                G4int nCopies = pv->IsReplicated() ? pv->GetMultiplicity() : 1;
+                for(G4int c = 0; c < nCopies && matches.size() < max; ++c) {
+                    G4int copyNo = pv->IsReplicated() ? c : pv->GetCopyNo();
+                    if(copyPattern != "") {
+                        std::ostringstream copyString;
+                        copyString<<copyNo;
+                        if(!Matches(copyPattern, copyString.str())) continue;
+                    }
+
+                    size_t nBefore = matches.size();
+                    current.push_back(std::make_pair(pv, copyNo));
+                    this->FindPaths(pv->GetLogicalVolume(), patterns, level + 1, current, matches, max);
+                    current.pop_back();
+
+                    //----- Every copy has the same subtree, so if one has no
+                    // matches below, none has
+                    if(matches.size() == nBefore && level + 1 < patterns.size()) break;
+                }
+            }
+        }
+
+
+        G4int VolumeIndex::CopyNumber(const G4VPhysicalVolume* pv)
+        {
+            return pv->IsReplicated() ? 0 : pv->GetCopyNo();
+        }
+
+    } // namespace geometry
+} // namespace latte
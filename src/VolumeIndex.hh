@@ -0,0 +1,135 @@
+#ifndef VOLUMEINDEX_HH
+#define VOLUMEINDEX_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Hashed lookup of logical and physical volumes by name, and
+//              of touchables by path, e.g. "/World:0/Det:3/Cell:12".
+//
+//              Names are interned once. Placements are keyed by (mother
+//              logical volume, name, copy number), which forms a path trie
+//              over the geometry graph: shared logical volumes share their
+//              subtree, so the index grows with placements, not touchables.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "globals.hh"
+
+#include <boost/unordered_map.hpp>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+namespace latte {
+    namespace geometry {
+
+        class VolumeIndex
+        {
+            public:
+                //----- (volume, copy number), outermost first
+                typedef std::vector<std::pair<G4VPhysicalVolume*, G4int> > Path;
+                typedef std::vector<G4LogicalVolume*>   LogicalList;
+                typedef std::vector<G4VPhysicalVolume*> PhysicalList;
+
+            public:
+                VolumeIndex();
+                ~VolumeIndex();
+
+                //----- Index the stores and the tree below world
+                void Build(G4VPhysicalVolume* world);
+                void Clear();
+                G4bool IsBuilt() const {return pWorld_ != 0;}
+
+                //----- All volumes with exactly this name, empty if none
+                const LogicalList& FindLogical(const std::string& name) const;
+                const PhysicalList& FindPhysical(const std::string& name) const;
+
+                //----- Resolve "/World:0/Det:3", or "/" for the world. A
+                // missing copy number picks the first placement with that
+                // name.
+                G4bool Resolve(const std::string& path, Path& out) const;
+
+                //----- Resolve a path, or else the first placement of a
+                // physical volume of that name
+                G4bool ResolveNameOrPath(const std::string& nameOrPath, Path& out) const;
+
+                //----- One path from the world to pv
+                G4bool PathTo(G4VPhysicalVolume* pv, Path& out) const;
+
+                //----- Shell glob over volume names, or over paths if it
+                // starts with '/'. Appends at most max descriptions.
+                size_t Find(const std::string& glob, std::vector<std::string>& matches, size_t max) const;
+
+                static std::string ToString(const Path& path);
+
+            private:
+                struct NameEntry
+                {
+                    std::string  name;
+                    LogicalList  logicals;
+                    PhysicalList physicals;
+                };
+
+                struct PlacementKey
+                {
+                    PlacementKey(const G4LogicalVolume* m, uint32_t n, G4int c) : mother(m), name(n), copy(c) {;}
+
+                    bool operator==(const PlacementKey& rhs) const
+                    {
+                        return mother == rhs.mother && name == rhs.name && copy == rhs.copy;
+                    }
+
+                    friend std::size_t hash_value(const PlacementKey& k)
+                    {
+                        std::size_t seed = 0;
+                        boost::hash_combine(seed, k.mother);
+                        boost::hash_combine(seed, k.name);
+                        boost::hash_combine(seed, k.copy);
+                        return seed;
+                    }
+
+                    const G4LogicalVolume* mother;
+                    uint32_t               name;
+                    G4int                  copy;
+                };
+
+                typedef boost::unordered_map<std::string, uint32_t> NameToIDMap;
+                typedef boost::unordered_map<PlacementKey, G4VPhysicalVolume*> PlacementMap;
+                typedef boost::unordered_map<PlacementKey, PhysicalList> NamedPlacementMap;
+                typedef boost::unordered_map<const G4VPhysicalVolume*, G4LogicalVolume*> MotherMap;
+                typedef boost::unordered_map<const G4LogicalVolume*, G4VPhysicalVolume*> FirstPlacementMap;
+
+                //----- Special copy numbers in PlacementKey. Placements of a
+                // name under a mother, in daughter order, are keyed kAnyCopy.
+                static const G4int kAnyCopy;
+                static const G4int kReplicated;
+
+            private:
+                uint32_t Intern(const std::string& name);
+                const NameEntry* Lookup(const std::string& name) const;
+                G4VPhysicalVolume* Daughter(const G4LogicalVolume* mother, const std::string& name, G4int& copy) const;
+                void FindPaths(const G4LogicalVolume* mother, const std::vector<std::string>& patterns, size_t level,
+                        Path& current, std::vector<std::string>& matches, size_t max) const;
+
+                static G4int CopyNumber(const G4VPhysicalVolume* pv);
+
+            private:
+                G4VPhysicalVolume* pWorld_;
+                NameToIDMap        nameIDs_;
+                std::vector<NameEntry> names_;
+                PlacementMap       placements_;
+                NamedPlacementMap  namedPlacements_;
+                MotherMap          mothers_;
+                FirstPlacementMap  firstPlacements_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // VOLUMEINDEX_HH
@@ -0,0 +1,168 @@
+#include "VolumeIndexMessenger.hh"
+
+#include "VolumeIndex.hh"
+
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UImanager.hh"
+#include "G4VisManager.hh"
+#include "G4Scene.hh"
+#include "G4PhysicalVolumeModel.hh"
+#include "G4ReplicaNavigation.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Material.hh"
+#include "G4ios.hh"
+
+#include <sstream>
+
+namespace {
+    //----- Transform from the frame of path[n] to the world. Replica and
+    // parameterised levels are set up for their copy number first.
+    G4Transform3D GlobalTransform(const latte::geometry::VolumeIndex::Path& path, size_t n)
+    {
+        G4Transform3D transform;
+        G4ReplicaNavigation replicaNavigation;
+
+        for(size_t level = 1; level <= n && level < path.size(); ++level) {
+            G4VPhysicalVolume* pv = path[level].first;
+            G4int copy = path[level].second;
+            if(pv->IsParameterised()) {
+                pv->GetParameterisation()->ComputeTransformation(copy, pv);
+            }
+            else if(pv->IsReplicated()) {
+                replicaNavigation.ComputeTransformation(copy, pv);
+            }
+            transform = transform*G4Transform3D(pv->GetObjectRotationValue(), pv->GetObjectTranslation());
+        }
+        return transform;
+    }
+}
+
+namespace latte {
+    namespace geometry {
+
+        VolumeIndexMessenger::VolumeIndexMessenger(VolumeIndex* messengedObject) : G4UImessenger(),
+        pMessengedIndex_(messengedObject), pFindCmd_(0), pDrawVolumeCmd_(0), pTouchableCmd_(0)
+        {
+            //----- Default Constructor
+            pFindCmd_ = new G4UIcommand("/gdmlview/find",this);
+            pFindCmd_->SetGuidance("list volumes whose name matches a shell glob, e.g. \"Cell*\"");
+            pFindCmd_->SetGuidance("globs starting with / match touchable paths, e.g. \"/World/Det:*/Cell:1?\"");
+            pFindCmd_->SetParameter(new G4UIparameter("glob", 's', false));
+            G4UIparameter* max = new G4UIparameter("max", 'i', true);
+            max->SetDefaultValue(100);
+            max->SetParameterRange("max > 0");
+            pFindCmd_->SetParameter(max);
+            pFindCmd_->AvailableForStates(G4State_Idle);
+
+            pDrawVolumeCmd_ = new G4UIcmdWithAString("/gdmlview/drawVolume",this);
+            pDrawVolumeCmd_->SetGuidance("draw a physical volume, by name or by path \"/World:0/Det:3\"");
+            pDrawVolumeCmd_->SetGuidance("like /vis/drawVolume, in a new scene, but in its global position");
+            pDrawVolumeCmd_->SetParameterName("volume", false);
+            pDrawVolumeCmd_->AvailableForStates(G4State_Idle);
+
+            pTouchableCmd_ = new G4UIcmdWithAString("/gdmlview/touchable",this);
+            pTouchableCmd_->SetGuidance("print a touchable, by name or by path, and make it the /vis/set/touchable");
+            pTouchableCmd_->SetParameterName("volume", false);
+            pTouchableCmd_->AvailableForStates(G4State_Idle);
+        }
+
+        VolumeIndexMessenger::~VolumeIndexMessenger()
+        {
+            //----- Destructor
+            delete pTouchableCmd_;
+            delete pDrawVolumeCmd_;
+            delete pFindCmd_;
+        }
+
+
+        void VolumeIndexMessenger::SetNewValue(G4UIcommand* cmd, G4String args)
+        {
+            //----- Messenge object
+            if ( cmd == pFindCmd_) {
+                this->Find(args);
+            }
+            else if ( cmd == pDrawVolumeCmd_) {
+                this->DrawVolume(args);
+            }
+            else if ( cmd == pTouchableCmd_) {
+                this->PrintTouchable(args);
+            }
+        }
+
+
+        void VolumeIndexMessenger::Find(const G4String& args)
+        {
+            std::istringstream is(args);
+            std::string glob;
+            size_t max(100);
+            is>>glob>>max;
+
+            std::vector<std::string> matches;
+            size_t n = pMessengedIndex_->Find(glob, matches, max);
+            for(std::vector<std::string>::const_iterator m = matches.begin(); m != matches.end(); ++m) {
+                G4cout<<*m<<G4endl;
+            }
+            G4cout<<n<<" match"<<(n == 1 ? "" : "es")<<(n == max ? " (limit reached)" : "")<<G4endl;
+        }
+
+
+        void VolumeIndexMessenger::DrawVolume(const G4String& nameOrPath)
+        {
+            VolumeIndex::Path path;
+            if(!pMessengedIndex_->ResolveNameOrPath(nameOrPath, path)) {
+                G4cerr<<"gdmlview: no volume \""<<nameOrPath<<"\""<<G4endl;
+                return;
+            }
+
+            G4UImanager* UI = G4UImanager::GetUIpointer();
+            UI->ApplyCommand("/vis/scene/create");
+
+            G4VisManager* pVisManager = G4VisManager::GetInstance();
+            G4Scene* pScene = pVisManager ? pVisManager->GetCurrentScene() : 0;
+            if(!pScene) {
+                G4cerr<<"gdmlview: no scene to draw into, is visualization enabled?"<<G4endl;
+                return;
+            }
+
+            //----- The model applies the volume's own placement
+            G4PhysicalVolumeModel* pModel = new G4PhysicalVolumeModel(path.back().first,
+                    G4PhysicalVolumeModel::UNLIMITED, GlobalTransform(path, path.size() - 2));
+            pScene->AddRunDurationModel(pModel, true);
+            UI->ApplyCommand("/vis/sceneHandler/attach");
+        }
+
+
+        void VolumeIndexMessenger::PrintTouchable(const G4String& nameOrPath)
+        {
+            VolumeIndex::Path path;
+            if(!pMessengedIndex_->ResolveNameOrPath(nameOrPath, path)) {
+                G4cerr<<"gdmlview: no volume \""<<nameOrPath<<"\""<<G4endl;
+                return;
+            }
+
+            G4VPhysicalVolume* pv = path.back().first;
+            G4LogicalVolume* lv = pv->GetLogicalVolume();
+            G4Transform3D transform = GlobalTransform(path, path.size() - 1);
+            const G4Material* material = lv->GetMaterial();
+
+            G4cout<<"path      "<<VolumeIndex::ToString(path)<<G4endl
+                  <<"logical   "<<lv->GetName()<<G4endl
+                  <<"solid     "<<lv->GetSolid()->GetName()<<" ("<<lv->GetSolid()->GetEntityType()<<")"<<G4endl
+                  <<"material  "<<(material ? material->GetName() : G4String("-"))<<G4endl
+                  <<"daughters "<<lv->GetNoDaughters()<<G4endl
+                  <<"position  "<<transform.getTranslation()<<" mm"<<G4endl;
+
+            //----- Hand over to the standard /vis/touchable/ commands
+            std::ostringstream touchable;
+            for(VolumeIndex::Path::const_iterator level = path.begin(); level != path.end(); ++level) {
+                touchable<<" "<<level->first->GetName()<<" "<<level->second;
+            }
+            G4UImanager::GetUIpointer()->ApplyCommand("/vis/set/touchable" + touchable.str());
+        }
+
+    } // namespace geometry
+} // namespace latte
@@ -0,0 +1,47 @@
+#ifndef VOLUMEINDEXMESSENGER_HH
+#define VOLUMEINDEXMESSENGER_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Volume search and selection commands answered from a
+//              VolumeIndex rather than by walking the geometry
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the  license.
+//=============================================================================
+
+#include "G4UImessenger.hh"
+
+class G4UIcommand;
+class G4UIcmdWithAString;
+
+namespace latte {
+    namespace geometry {
+
+        class VolumeIndex;
+
+        class VolumeIndexMessenger : public G4UImessenger
+        {
+            public:
+                VolumeIndexMessenger(VolumeIndex* messengedObject);
+                virtual ~VolumeIndexMessenger();
+
+                void SetNewValue(G4UIcommand* cmd, G4String args);
+
+            private:
+                void Find(const G4String& args);
+                void DrawVolume(const G4String& nameOrPath);
+                void PrintTouchable(const G4String& nameOrPath);
+
+            private:
+                VolumeIndex*        pMessengedIndex_;
+
+                G4UIcommand*        pFindCmd_;
+                G4UIcmdWithAString* pDrawVolumeCmd_;
+                G4UIcmdWithAString* pTouchableCmd_;
+        };
+
+    } // namespace geometry
+} // namespace latte
+#endif // VOLUMEINDEXMESSENGER_HH
@@ -0,0 +1,100 @@
+#include "Xoshiro256Engine.hh"
+
+#include <fstream>
+#include <iostream>
+
+namespace latte {
+    namespace random {
+
+        Xoshiro256Engine::Xoshiro256Engine(uint64_t seed) : CLHEP::HepRandomEngine()
+        {
+            this->SetSeed64(seed);
+        }
+
+
+        Xoshiro256Engine::~Xoshiro256Engine()
+        {;}
+
+
+        void Xoshiro256Engine::SetSeed64(uint64_t seed)
+        {
+            //----- SplitMix expansion never yields the all zero state
+            uint64_t sm = seed;
+            for(int i = 0; i < 4; ++i) s_[i] = SplitMix64(sm);
+            theSeed = static_cast<long>(seed);
+        }
+
+
+        double Xoshiro256Engine::flat()
+        {
+            return ToDouble(this->Next());
+        }
+
+
+        void Xoshiro256Engine::flatArray(const int size, double* vect)
+        {
+            for(int i = 0; i < size; ++i) vect[i] = ToDouble(this->Next());
+        }
+
+
+        void Xoshiro256Engine::setSeed(long seed, int)
+        {
+            this->SetSeed64(static_cast<uint64_t>(seed));
+        }
+
+
+        void Xoshiro256Engine::setSeeds(const long* seeds, int)
+        {
+            //----- Fold a zero terminated list into one seed
+            uint64_t seed = 0;
+            for(const long* p = seeds; p && *p; ++p) {
+                seed = DeriveSeed(seed, static_cast<uint64_t>(*p));
+            }
+            this->SetSeed64(seed);
+            theSeeds = seeds;
+        }
+
+
+        void Xoshiro256Engine::saveStatus(const char filename[]) const
+        {
+            std::ofstream out(filename);
+            if(!out) {
+                std::cerr<<"Xoshiro256Engine: cannot save status to "<<filename<<std::endl;
+                return;
+            }
+            out<<this->name()<<"\n";
+            for(int i = 0; i < 4; ++i) out<<s_[i]<<"\n";
+        }
+
+
+        void Xoshiro256Engine::restoreStatus(const char filename[])
+        {
+            std::ifstream in(filename);
+            std::string tag;
+            uint64_t s[4];
+
+            in>>tag>>s[0]>>s[1]>>s[2]>>s[3];
+            if(!in || tag != this->name()) {
+                std::cerr<<"Xoshiro256Engine: cannot restore status from "<<filename<<std::endl;
+                return;
+            }
+            for(int i = 0; i < 4; ++i) s_[i] = s[i];
+        }
+
+
+        void Xoshiro256Engine::showStatus() const
+        {
+            std::cout<<"--------- "<<this->name()<<" engine status ---------"<<std::endl
+                     <<" Initial seed = "<<theSeed<<std::endl
+                     <<" State        = "<<s_[0]<<" "<<s_[1]<<" "<<s_[2]<<" "<<s_[3]<<std::endl
+                     <<"-------------------------------------------------"<<std::endl;
+        }
+
+
+        std::string Xoshiro256Engine::name() const
+        {
+            return "Xoshiro256Engine";
+        }
+
+    } // namespace random
+} // namespace latte
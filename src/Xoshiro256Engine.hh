@@ -0,0 +1,90 @@
+#ifndef XOSHIRO256ENGINE_HH
+#define XOSHIRO256ENGINE_HH
+
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: CLHEP random engine wrapping xoshiro256+ (Blackman & Vigna).
+//              Small state, a few cycles per number, and cheap to reseed,
+//              which makes per-event substreams affordable.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the GPL license.
+//=============================================================================
+
+#include "Randomize.hh"
+
+#include <stdint.h>
+#include <string>
+
+namespace latte {
+    namespace random {
+
+        //----- SplitMix64 step, used to expand and derive seeds
+        inline uint64_t SplitMix64(uint64_t& state)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        //----- Deterministically derive an independent seed from a parent
+        // seed and two indices (e.g. run and event number)
+        inline uint64_t DeriveSeed(uint64_t parent, uint64_t a, uint64_t b = 0)
+        {
+            uint64_t s = parent;
+            uint64_t h = SplitMix64(s);
+            s = h ^ a;
+            h = SplitMix64(s);
+            s = h ^ b;
+            return SplitMix64(s);
+        }
+
+        class Xoshiro256Engine : public CLHEP::HepRandomEngine
+        {
+            public:
+                explicit Xoshiro256Engine(uint64_t seed = 0);
+                virtual ~Xoshiro256Engine();
+
+                //----- Reset the state from a 64 bit seed
+                void SetSeed64(uint64_t seed);
+
+                //----- HepRandomEngine interface
+                virtual double flat();
+                virtual void flatArray(const int size, double* vect);
+                virtual void setSeed(long seed, int);
+                virtual void setSeeds(const long* seeds, int);
+                virtual void saveStatus(const char filename[] = "Xoshiro256.conf") const;
+                virtual void restoreStatus(const char filename[] = "Xoshiro256.conf");
+                virtual void showStatus() const;
+                virtual std::string name() const;
+
+            private:
+                uint64_t Next()
+                {
+                    const uint64_t result = s_[0] + s_[3];
+                    const uint64_t t = s_[1] << 17;
+                    s_[2] ^= s_[0];
+                    s_[3] ^= s_[1];
+                    s_[1] ^= s_[2];
+                    s_[0] ^= s_[3];
+                    s_[2] ^= t;
+                    s_[3] = (s_[3] << 45) | (s_[3] >> 19);
+                    return result;
+                }
+
+                //----- Top 52 bits mapped to the open interval (0,1), as
+                // CLHEP engines never return 0
+                static double ToDouble(uint64_t x)
+                {
+                    return (static_cast<double>(x >> 12) + 0.5) * (1.0/4503599627370496.0);
+                }
+
+            private:
+                uint64_t s_[4];
+        };
+
+    } // namespace random
+} // namespace latte
+#endif // XOSHIRO256ENGINE_HH
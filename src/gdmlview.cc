@@ -4,16 +4,40 @@
 #include "DetectorConstructor.hh"
 #include "ExN01PhysicsList.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "UserActionDispatcher.hh"
+#include "TrajectoryStore.hh"
+#include "TrajectoryStoreRecorder.hh"
+#include "TrajectoryStoreMessenger.hh"
+#include "StepRecorder.hh"
+#include "StepRecorderMessenger.hh"
+#include "ProfilingNavigator.hh"
+#include "NavigationProfiler.hh"
+#include "NavigationProfilerMessenger.hh"
+#include "PointLocator.hh"
+#include "BulkLocator.hh"
+#include "BulkLocatorMessenger.hh"
+#include "StartupTimeline.hh"
+#include "BatchValidator.hh"
 
 
 #include "G4RunManager.hh"
 #include "G4VisExecutive.hh"
+#include "G4UImanager.hh"
+
+#include <algorithm>
+#include <sstream>
 
 int main(int argc, char** argv)
 {
+    //----- Startup phases are timed from here
+    latte::profile::StartupTimeline& timeline = latte::profile::StartupTimeline::Instance();
+
     //----- Parse command line args.
     GdmlCmdLineParser psr(argc,argv);
-    psr.parse();
+    {
+        latte::profile::StartupTimeline::Phase phase("main", "arguments");
+        psr.parse();
+    }
 
     //----- Check for interactive session, and start if needed
     std::string userSession(psr.shell_name());
@@ -29,51 +53,179 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    //----- Batch validation forks a worker per file, so must run before
+    // any Geant4 state exists in this process
+    if(psr.validate()) {
+        latte::validate::BatchValidator validator;
+        validator.SetJobs(psr.jobs());
+        validator.SetTimeout(psr.validate_timeout());
+        validator.SetOverlapResolution(psr.overlap_resolution());
+        validator.SetTopVolumes(psr.stats_top());
+        return validator.Run(psr.gdml_files(), psr.report_file()) ? 1 : 0;
+    }
+
+    if(psr.gdml_files().size() > 1) {
+        std::cerr<<"gdmlview: more than one file operand, use --validate to check several"<<std::endl;
+        return 1;
+    }
+
+    //----- Batch point location and statistics need neither session nor
+    // visualization
+    std::string locateFile(psr.locate_file());
+    bool isBatch(locateFile != "" || psr.stats());
+
+    //----- Located points written to stdout must not be mixed with the
+    // banner and other output, which all goes through std::cout
+    if(locateFile != "" && psr.locate_output() == "-") {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    //----- Check the session before anything starts running in the
+    // background
+    latte::UISessionFactory uif = latte::BuildUISessionFactory();
+    if(userSession != "" && !isBatch && !uif.IsRegistered(userSession)) {
+        std::cerr<<"gdmlview does not recognize the session \""<<userSession<<"\""<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //----- Navigation profiling replaces the tracking navigator, which the
+    // run manager's stepping manager caches on construction
+    std::string profileFile(psr.profile_file());
+    latte::profile::ProfilingNavigator* pProfilingNavigator = 0;
+    if(profileFile != "") {
+        pProfilingNavigator = latte::profile::ProfilingNavigator::Install();
+    }
+
+    //----- The kernel installs the default exception handler, which the
+    // geometry builder's then stands in for
+    boost::shared_ptr<G4RunManager> rm;
+    {
+        latte::profile::StartupTimeline::Phase phase("main", "run manager");
+        rm.reset(new G4RunManager());
+    }
+
+    //----- Start reading the geometry straight away. It is parsed, indexed
+    // and voxelized on a background thread while the session, physics and
+    // visualization are set up, and collected by rm->Initialize().
+    latte::geometry::DetectorConstructor* pDetector = new latte::geometry::DetectorConstructor;
+    G4UImanager::GetUIpointer()->ApplyCommand("/gdmlview/read "+userGdmlFile);
+    pDetector->Prefetch();
+
     boost::shared_ptr<G4UIsession> session;
 
-    if(userSession != "") {
-        latte::UISessionFactory uif = latte::BuildUISessionFactory();
+    if(psr.socket_path() != "") {
+        latte::UISocketSession::SetSocketPath(psr.socket_path());
+    }
+
+    if(userSession != "" && !isBatch) {
+        latte::profile::StartupTimeline::Phase phase("main", "ui session");
         session = boost::shared_ptr<G4UIsession>(uif.CreateProduct(userSession,argc,argv));
-        if(!session) {
-            std::cerr<<"gdmlview does not recognize the session \""<<userSession<<"\""<<std::endl;
-            exit(EXIT_FAILURE);
-        }
     }
 
-    //----- Initialize random number generation.
-    latte::random::DefaultRandomizePolicy::configure();
+    //----- Initialize random number generation. Events are reseeded from
+    // the master seed, so printing it is enough to reproduce the run.
+    uint64_t masterSeed(0);
+    if(psr.has_job_index()) {
+        masterSeed = latte::random::SeedFromJobIndex::configure(psr.seed(), psr.job_index());
+    }
+    else if(psr.has_seed()) {
+        masterSeed = latte::random::FixedSeed::configure(psr.seed());
+    }
+    else {
+        masterSeed = latte::random::DefaultRandomizePolicy::configure();
+    }
+    latte::random::EventSeeder eventSeeder(masterSeed);
+    std::cout<<"gdmlview: master random seed "<<masterSeed<<std::endl;
 
     //----- Setup Kernel and user modules.
-    boost::shared_ptr<G4RunManager> rm(new G4RunManager());
-    rm->SetUserInitialization(new latte::geometry::DetectorConstructor);
-    rm->SetUserInitialization(new ExN01PhysicsList);
-    rm->SetUserAction(new latte::generator::PrimaryGeneratorAction);
+    rm->SetUserInitialization(pDetector);
+    {
+        latte::profile::StartupTimeline::Phase phase("main", "physics list");
+        rm->SetUserInitialization(new ExN01PhysicsList);
+    }
+    latte::generator::PrimaryGeneratorAction* pPrimaryAction = new latte::generator::PrimaryGeneratorAction;
+    pPrimaryAction->SetEventSeeder(&eventSeeder);
+    rm->SetUserAction(pPrimaryAction);
+
+    //----- Observers of run/event/track/step. The compact trajectory store
+    // replaces G4TrajectoryContainer so long geantino scans stay bounded in
+    // memory.
+    latte::action::UserActionDispatcher dispatcher;
+    latte::vis::TrajectoryStore trajStore;
+    latte::vis::TrajectoryStoreRecorder trajRecorder(&trajStore);
+    latte::vis::TrajectoryStoreMessenger trajMessenger(&trajStore, &trajRecorder);
+    dispatcher.Attach(&trajRecorder);
+
+    latte::steprecord::StepRecorder stepRecorder;
+    latte::steprecord::StepRecorderMessenger stepMessenger(&stepRecorder);
+    dispatcher.Attach(&stepRecorder);
+
+    boost::shared_ptr<latte::profile::NavigationProfiler> profiler;
+    boost::shared_ptr<latte::profile::NavigationProfilerMessenger> profilerMessenger;
+    if(pProfilingNavigator) {
+        profiler.reset(new latte::profile::NavigationProfiler(pProfilingNavigator, profileFile));
+        profilerMessenger.reset(new latte::profile::NavigationProfilerMessenger(profiler.get()));
+        dispatcher.Attach(profiler.get());
+    }
+
+    dispatcher.Install(rm.get());
+
+    latte::geometry::PointLocator pointLocator;
+    pDetector->Attach(&pointLocator);
+    latte::geometry::BulkLocator bulkLocator(&pointLocator);
+    latte::geometry::BulkLocatorMessenger bulkLocatorMessenger(&bulkLocator);
+
+    if(isBatch) {
+        {
+            latte::profile::StartupTimeline::Phase phase("main", "initialize");
+            rm->Initialize();
+        }
+        if(psr.timeline()) timeline.Print(G4cout);
+        timeline.Close();
 
+        if(psr.stats()) {
+            std::ostringstream top;
+            top<<std::max(psr.stats_top(), 0);
+            G4UImanager::GetUIpointer()->ApplyCommand("/gdmlview/stats "+top.str());
+        }
+        if(locateFile == "") return 0;
+        return bulkLocator.Run(locateFile, psr.locate_output()) ? 0 : 1;
+    }
     
     //----- We should now be able to open the session and initialize everything
     // We want visualization...
-    boost::shared_ptr<G4VisManager> pVisManager(new G4VisExecutive);
-
-    // But make it shut the hell up.
-    //pVisManager->SetVerboseLevel(G4VisManager::quiet);
-    pVisManager->Initialize();
+    boost::shared_ptr<G4VisManager> pVisManager;
+    {
+        latte::profile::StartupTimeline::Phase phase("main", "vis manager");
+        pVisManager.reset(new G4VisExecutive);
+
+        // But make it shut the hell up.
+        //pVisManager->SetVerboseLevel(G4VisManager::quiet);
+        pVisManager->Initialize();
+    }
 
-    // Pre apply commands needed to start up, open supplied gdmlfile
-    // and fire up visualization
+    // Initialize with the prefetched geometry, then fire up visualization
     G4UImanager* uiMan = G4UImanager::GetUIpointer();
-    uiMan->ApplyCommand("/gdmlview/read "+userGdmlFile);
-    uiMan->ApplyCommand("/gdmlview/update");
-    rm->Initialize();
-
-    uiMan->ApplyCommand("/vis/scene/create");
-    if (userSession == "qt") {
-        uiMan->ApplyCommand("/vis/open OGLSQt 800 600");
+    {
+        latte::profile::StartupTimeline::Phase phase("main", "initialize");
+        rm->Initialize();
     }
-    else {
-        uiMan->ApplyCommand("/vis/open OGLSX 800 600");
+
+    //----- The socket session runs headless, as a resident geometry server
+    if (userSession != "socket") {
+        uiMan->ApplyCommand("/vis/scene/create");
+        if (userSession == "qt") {
+            uiMan->ApplyCommand("/vis/open OGLSQt 800 600");
+        }
+        else {
+            uiMan->ApplyCommand("/vis/open OGLSX 800 600");
+        }
+        uiMan->ApplyCommand("/vis/viewer/flush");
+        uiMan->ApplyCommand("/gdmlview/trajectories/draw");
     }
-    uiMan->ApplyCommand("/vis/viewer/flush");
-    uiMan->ApplyCommand("/vis/scene/add/trajectories");
+
+    if(psr.timeline()) timeline.Print(G4cout);
+    timeline.Close();
 
     // Start the session
     session->SessionStart();
@@ -0,0 +1,79 @@
+//=============================================================================
+// Author     : gdmlview contributors
+// Description: Summarize a gdmlview step record file: steps and track length
+//              per volume. Also serves as an example of the reader API.
+//
+// Copyright (c) 2026 gdmlview contributors
+//
+// Redistribution and use is allowed according to the terms of the GPL license.
+//=============================================================================
+
+#include "StepRecordReader.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+    struct VolumeSummary
+    {
+        uint32_t id;
+        uint64_t nSteps;
+        double   length;
+
+        bool operator<(const VolumeSummary& rhs) const {return nSteps > rhs.nSteps;}
+    };
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 2) {
+        std::cerr<<"usage: gdmlview-stepdump <step-record-file>"<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        latte::steprecord::StepRecordReader reader(argv[1]);
+        const std::vector<std::string>& volumes = reader.GetVolumeNames();
+
+        std::vector<VolumeSummary> summary(volumes.size());
+        for(size_t i = 0; i < summary.size(); ++i) {
+            summary[i].id = static_cast<uint32_t>(i);
+            summary[i].nSteps = 0;
+            summary[i].length = 0.;
+        }
+
+        //----- Only the volume and length columns are touched, so only
+        // those pages are read from disk
+        for(size_t c = 0; c < reader.GetNumberOfChunks(); ++c) {
+            latte::steprecord::ChunkView v = reader.GetChunk(c);
+            for(uint32_t i = 0; i < v.nRecords; ++i) {
+                if(v.volumeID[i] >= summary.size()) continue;
+                VolumeSummary& s = summary[v.volumeID[i]];
+                ++s.nSteps;
+                s.length += v.stepLength[i];
+            }
+        }
+
+        std::sort(summary.begin(), summary.end());
+
+        std::cout<<argv[1]<<": "<<reader.GetNumberOfRecords()<<" steps in "
+                 <<reader.GetNumberOfChunks()<<" chunks, "
+                 <<volumes.size()<<" volumes, "
+                 <<reader.GetMaterialNames().size()<<" materials"<<std::endl;
+        std::cout<<std::setw(14)<<"steps"<<std::setw(18)<<"length [mm]"<<"  volume"<<std::endl;
+        for(size_t i = 0; i < summary.size(); ++i) {
+            std::cout<<std::setw(14)<<summary[i].nSteps
+                     <<std::setw(18)<<summary[i].length
+                     <<"  "<<volumes[summary[i].id]<<std::endl;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr<<"gdmlview-stepdump: "<<e.what()<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}